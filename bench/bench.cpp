@@ -0,0 +1,327 @@
+// (c) 2025 Stardust Softworks
+// lmc_bench: times LMC's own share of a build on generated projects, never a real compiler.
+// the compiler is this executable again (LMC_BENCH_STUB set), it writes the object, depfile
+// and target clang would and exits, so what's left is scanning, detection, probes, flag
+// assembly, up-to-date checks, process spawning and the log. works offline.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "buildengine.h"
+#include "compilecache.h"
+#include "libregistry.h"
+#include "logsink.h"
+#include "probecache.h"
+#include "sourcescan.h"
+
+// the stub compiler: -o and -MF are all it cares about, plain C I/O so it starts fast
+static int lmc_stubCompiler(int argc, char *argv[])
+{
+    const char *src = nullptr;
+    const char *obj = nullptr;
+    const char *dep = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "-c") == 0)
+            src = argv[++i];
+        else if (std::strcmp(argv[i], "-o") == 0)
+            obj = argv[++i];
+        else if (std::strcmp(argv[i], "-MF") == 0)
+            dep = argv[++i];
+    }
+    if (!obj)
+        return 0;
+    if (FILE *f = std::fopen(obj, "wb")) {
+        std::fputs("lmc_bench stub output\n", f);
+        std::fclose(f);
+    }
+    // every TU depends on the whole generated header chain, like the real one would
+    if (dep && src) {
+        if (FILE *f = std::fopen(dep, "wb")) {
+            const char *headers = std::getenv("LMC_BENCH_DEPS");
+            std::fprintf(f, "%s: %s %s\n", obj, src, headers ? headers : "");
+            std::fclose(f);
+        }
+    }
+    return 0;
+}
+
+struct LmcBenchProject
+{
+    QStringList sources;
+    QStringList headers;
+    QString includeDir;
+};
+
+// header k includes header k+1, every source includes header 0 and one library header
+// (round robin), source 0 has main(). padded so the scanner has bytes to chew through
+static LmcBenchProject lmc_writeProject(const QString &root, int sources, int depth,
+                                        const QStringList &libHeaders)
+{
+    LmcBenchProject project;
+    QDir(root).mkpath("src");
+    QDir(root).mkpath("include");
+    project.includeDir = QDir(root).absoluteFilePath("include");
+
+    QByteArray padding;
+    for (int i = 0; i < 40; ++i)
+        padding += "int lmc_pad_" + QByteArray::number(i) + "(int x) { return x * "
+                   + QByteArray::number(i) + "; } // filler for the scanner\n";
+
+    for (int k = 0; k < depth; ++k) {
+        const QString path = QDir(project.includeDir).absoluteFilePath(
+            QString("lmc_bench_%1.h").arg(k));
+        QByteArray text = "#pragma once\n";
+        if (k + 1 < depth)
+            text += "#include \"lmc_bench_" + QByteArray::number(k + 1) + ".h\"\n";
+        text += "#include <vector>\nnamespace lmc_bench_" + QByteArray::number(k) + " {\n"
+                + padding + "}\n";
+        QFile f(path);
+        if (f.open(QIODevice::WriteOnly))
+            f.write(text);
+        project.headers << path;
+    }
+
+    for (int i = 0; i < sources; ++i) {
+        const QString path = QDir(root).absoluteFilePath(QString("src/s%1.cpp").arg(i, 5, 10,
+                                                                                   QChar('0')));
+        QByteArray text;
+        if (depth > 0)
+            text += "#include \"lmc_bench_0.h\"\n";
+        if (!libHeaders.isEmpty())
+            text += "#include <" + libHeaders.at(i % libHeaders.size()).toUtf8() + ">\n";
+        text += "#include <string>\n\n" + padding;
+        text += "int lmc_source_" + QByteArray::number(i) + "() { return "
+                + QByteArray::number(i) + "; }\n";
+        if (i == 0)
+            text += "\nint main() { return lmc_source_0(); }\n";
+        QFile f(path);
+        if (f.open(QIODevice::WriteOnly))
+            f.write(text);
+        project.sources << path;
+    }
+    return project;
+}
+
+static QString lmc_ms(qint64 nsecs)
+{
+    if (nsecs >= 1000000000LL)
+        return QString::number(nsecs / 1e9, 'f', 2) + " s";
+    return QString::number(nsecs / 1e6, 'f', 1) + " ms";
+}
+
+static void lmc_removeCacheFile(const QString &name)
+{
+    QFile::remove(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/" + name);
+}
+
+// start() and wait; finished() may already have fired when start() returns
+static bool lmc_runBuild(BuildEngine &engine, const LmcBuildConfig &config)
+{
+    QEventLoop loop;
+    bool done = false;
+    bool ok = false;
+    const auto c = QObject::connect(&engine, &BuildEngine::finished, &loop, [&](bool good) {
+        done = true;
+        ok = good;
+        loop.quit();
+    });
+    if (engine.start(config) && !done)
+        loop.exec();
+    QObject::disconnect(c);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    if (std::getenv("LMC_BENCH_STUB"))
+        return lmc_stubCompiler(argc, argv);
+
+    QCoreApplication::setOrganizationName("StardustSoftworks");
+    QCoreApplication::setApplicationName("lmc_bench");
+    QCoreApplication app(argc, argv);
+    // scan/probe/object caches go somewhere throwaway, never next to the real app's
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Time LMC's own pipeline overhead on generated projects.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"sizes", "Project sizes in sources, comma separated (default: 10,1000,10000).", "n,..."},
+        {"depth", "Project header chain every source includes (default: 4).", "n"},
+        {"libs", "Library headers to include, round robin: sdl, glfw, sfml or none "
+                 "(default: sdl,glfw,sfml).", "names"},
+        {{"j", "jobs"}, "Parallel stub compiles (default: one per hardware thread).", "n"},
+        {"log-lines", "Lines pushed through the log sink (default: 200000).", "n"},
+        {"no-build", "Skip the stub builds, time the in-process phases only."},
+        {"keep", "Keep the generated projects and print where they are."},
+    });
+    parser.process(app);
+    QTextStream out(stdout);
+
+    QList<int> sizes;
+    for (const QString &s : parser.value("sizes").split(',', Qt::SkipEmptyParts))
+        if (s.trimmed().toInt() > 0)
+            sizes << s.trimmed().toInt();
+    if (sizes.isEmpty())
+        sizes = {10, 1000, 10000};
+    const int depth = parser.isSet("depth") ? qMax(0, parser.value("depth").toInt()) : 4;
+    const int jobs = parser.isSet("jobs") ? qMax(1, parser.value("jobs").toInt())
+                                          : QThread::idealThreadCount();
+    const int logLines = parser.isSet("log-lines") ? qMax(1, parser.value("log-lines").toInt())
+                                                   : 200000;
+
+    const QHash<QString, QString> knownLibs{{"sdl", "SDL2/SDL.h"},
+                                            {"glfw", "GLFW/glfw3.h"},
+                                            {"sfml", "SFML/Graphics.hpp"}};
+    QStringList libHeaders;
+    const QString libs = parser.isSet("libs") ? parser.value("libs") : "sdl,glfw,sfml";
+    for (const QString &name : libs.split(',', Qt::SkipEmptyParts)) {
+        if (knownLibs.contains(name.trimmed().toLower()))
+            libHeaders << knownLibs.value(name.trimmed().toLower());
+        else if (name.trimmed() != "none")
+            out << "⚠️ Unknown library " << name << ", ignored\n";
+    }
+
+    QTemporaryDir tmp;
+    if (!tmp.isValid()) {
+        out << "❌ Could not create a temporary directory\n";
+        return 1;
+    }
+    tmp.setAutoRemove(!parser.isSet("keep"));
+
+#ifndef Q_OS_WIN
+    // an empty PATH: probes fail the same fast way on every machine, no linker gets picked up.
+    // not on Windows, the stub compiles would lose the Qt DLLs
+    const QString bin = QDir(tmp.path()).absoluteFilePath("bin");
+    QDir().mkpath(bin);
+    qputenv("PATH", QFile::encodeName(bin));
+#endif
+
+    out << "lmc_bench: " << jobs << " job(s), include depth " << depth << ", libraries: "
+        << (libHeaders.isEmpty() ? QString("none") : libHeaders.join(" ")) << "\n";
+
+    // log throughput: compiler-sized chunks into a sink that spills to disk, as in a build
+    {
+        LogSink sink;
+        sink.setSpillFile(QDir(tmp.path()).absoluteFilePath("log.txt"));
+        qint64 shown = 0;
+        QObject::connect(&sink, &LogSink::flushed, [&](const QString &text) {
+            shown += text.size();
+        });
+        const QString chunk = "src/s00042.cpp:17:5: warning: unused variable 'x' "
+                              "[-Wunused-variable]\n    int x = lmc_pad_3(4);\n        ^\n";
+        qint64 chars = 0;
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < logLines; i += 3) {
+            sink.append(chunk);
+            chars += chunk.size();
+            if (i % 3000 == 0)
+                app.processEvents(); // lets the 30 Hz flush timer fire like it would in the app
+        }
+        sink.flush();
+        sink.setSpillFile(QString());
+        const qint64 ns = qMax<qint64>(t.nsecsElapsed(), 1);
+        out << QString("log sink        %1 for %2 lines, %3 M chars/s, %4 k chars reached "
+                       "the view\n")
+                   .arg(lmc_ms(ns))
+                   .arg(logLines)
+                   .arg(chars / (ns / 1e9) / 1e6, 0, 'f', 1)
+                   .arg(shown / 1000);
+    }
+
+    for (const int size : std::as_const(sizes)) {
+        out << "\n== " << size << " source(s)\n";
+        out.flush();
+        const QString root = QDir(tmp.path()).absoluteFilePath(QString("p%1").arg(size));
+        QElapsedTimer t;
+        t.start();
+        const LmcBenchProject project = lmc_writeProject(root, size, depth, libHeaders);
+        out << "generate        " << lmc_ms(t.nsecsElapsed()) << "\n";
+
+        lmc_removeCacheFile("scan.dat");
+        QVector<LmcSourceInfo> infos;
+        {
+            SourceScanner scanner;
+            t.restart();
+            infos = scanner.scan(project.sources);
+            out << "scan (cold)     " << lmc_ms(t.nsecsElapsed()) << "\n";
+            scanner.commit();
+        }
+        SourceScanner scanner;
+        t.restart();
+        infos = scanner.scan(project.sources);
+        out << "scan (warm)     " << lmc_ms(t.nsecsElapsed()) << ", " << scanner.reused()
+            << " reused\n";
+
+        t.restart();
+        const QSet<QString> includes = scanner.includeClosure(project.sources, infos,
+                                                              {project.includeDir});
+        out << "include closure " << lmc_ms(t.nsecsElapsed()) << ", " << scanner.headersWalked()
+            << " header(s), " << includes.size() << " external include(s)\n";
+
+        t.restart();
+        const LibraryRegistry registry;
+        const QVector<LmcLibrary> detected = registry.detect(includes);
+        const QStringList probes = LibraryRegistry::probeCommands(detected);
+        out << "detect          " << lmc_ms(t.nsecsElapsed()) << ", " << detected.size()
+            << " librar(ies), " << probes.size() << " probe(s)\n";
+
+        lmc_removeCacheFile("probes.json");
+        {
+            ProbeCache cold;
+            cold.beginBuild();
+            t.restart();
+            cold.resolve(probes);
+            out << "probe (cold)    " << lmc_ms(t.nsecsElapsed()) << ", " << cold.runs()
+                << " run\n";
+        }
+        ProbeCache warm;
+        warm.beginBuild();
+        t.restart();
+        warm.resolve(probes);
+        out << "probe (warm)    " << lmc_ms(t.nsecsElapsed()) << ", " << warm.hits()
+            << " cached\n";
+
+        if (parser.isSet("no-build"))
+            continue;
+
+        // the whole pipeline: every TU through the stub, then a rebuild with nothing to do
+        qputenv("LMC_BENCH_STUB", "1"); // inherited by the compile jobs only, checked above
+        qputenv("LMC_BENCH_DEPS", QFile::encodeName(project.headers.join(' ')));
+        BuildEngine engine;
+        engine.compileCache()->setEnabled(false); // a cache hit would skip what's measured
+        LmcBuildConfig config;
+        config.files = project.sources;
+        config.compiler = QCoreApplication::applicationFilePath();
+        config.output = QDir(root).absoluteFilePath("out/app");
+        config.standard = "c++17";
+        config.includeDirs << project.includeDir;
+        config.cxxflags << "-O2 -Wall";
+        config.jobs = jobs;
+
+        t.restart();
+        bool ok = lmc_runBuild(engine, config);
+        out << "build (cold)    " << lmc_ms(t.nsecsElapsed()) << (ok ? "" : ", FAILED") << "\n"
+            << "                " << engine.timingSummary() << "\n";
+        t.restart();
+        ok = lmc_runBuild(engine, config);
+        out << "build (no-op)   " << lmc_ms(t.nsecsElapsed()) << (ok ? "" : ", FAILED") << "\n"
+            << "                " << engine.timingSummary() << "\n";
+        qunsetenv("LMC_BENCH_STUB");
+    }
+
+    if (parser.isSet("keep"))
+        out << "\nProjects kept in " << tmp.path() << "\n";
+    return 0;
+}
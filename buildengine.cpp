@@ -0,0 +1,1361 @@
+// (c) 2025 Stardust Softworks
+#include "buildengine.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileDevice>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSettings>
+#include "buildtrace.h"
+#include "compilecache.h"
+#include "incremental.h"
+#include "jobrunner.h"
+#include "libregistry.h"
+#include "linker.h"
+#include "logsink.h"
+#include "pch.h"
+#include "probecache.h"
+#include "profiles.h"
+#include "sourcescan.h"
+#include "timetrace.h"
+#include "tuhistory.h"
+#include "unity.h"
+
+// ThinLTO cache size before the linker starts pruning the oldest entries
+static const int kLtoCacheMB = 2048;
+
+// state of the build in flight, it lives from start() until finishBuild()
+struct LmcBuildRun
+{
+    enum Phase { Probe, Pch, Compile, Link };
+    Phase phase = Compile;
+
+    QString out;
+    QString buildDir;
+    QString compiler;
+    QByteArray compileSig;
+    bool timeTrace = false;
+    bool optRemarks = false;
+
+    // what start() worked out before the probes ran, planBuild() goes on from there
+    LmcBuildConfig config;
+    QStringList sources;
+    QVector<LmcSourceInfo> scanned;
+    QVector<LmcLibrary> detected;
+    QStringList cxxflags;
+    QStringList incSwitches;
+    QStringList defSwitches;
+    QStringList ldflags;
+    QStringList libs;
+    QStringList probing; // the commands of this probe round, by job index
+    bool versionAsked = false;
+
+    LmcJob pchJob; // only run when the .pch is stale
+    LmcTuFiles pchTu;
+    QByteArray pchSig;
+
+    QVector<LmcJob> jobs; // dirty TUs only
+    QVector<LmcTuFiles> jobTus;
+    QVector<QByteArray> jobKeys;
+    QVector<LmcUnityBatch> jobBatches; // members of a unity batch, no sources for a plain TU
+    QStringList objects; // every TU, in link order
+    QHash<QString, LmcTuHistory> history; // what earlier compiles measured, by source
+    bool historyChanged = false;
+    QHash<QString, double> weights; // lmc_compileWeight() of every source
+    LmcCompileEstimate estimate;    // for the ones history has no time for
+    bool objectsChanged = false;
+    int done = 0;
+    int failed = 0;
+
+    // unity batches that broke, their members get compiled on their own afterwards
+    QStringList compileFlags; // or @lmc_compile.rsp when they got long
+    QStringList cacheFlags; // empty when the compile cache is off for this build
+    QByteArray compilerId;
+    QVector<int> unityFailed;
+    QStringList unityCulprits; // named by a batch's errors, skipped later if they build alone
+
+    QStringList linkFlags; // everything after the objects and -o out
+    QString linkerNote;
+    QString ltoCacheDir; // set for ThinLTO builds
+    QSet<QString> ltoCacheBefore;
+    QStringList linkArgs;
+    QByteArray linkSig;
+    QString linkStamp;
+};
+
+static QStringList lmc_jsonStrings(const QJsonValue &v)
+{
+    QStringList out;
+    for (const QJsonValue &x : v.toArray())
+        out << x.toString();
+    return out;
+}
+
+bool LmcBuildConfig::load(const QString &path, QString *error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = f.errorString();
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error)
+            *error = parseError.errorString();
+        return false;
+    }
+    const QJsonObject o = doc.object();
+    const QDir base = QFileInfo(path).absoluteDir();
+
+    files.clear();
+    for (const QString &file : lmc_jsonStrings(o.value("files")))
+        files << QDir::cleanPath(base.absoluteFilePath(file));
+    output = o.value("output").toString();
+    if (!output.isEmpty())
+        output = QDir::cleanPath(base.absoluteFilePath(output));
+    compiler = o.value("compiler").toString();
+    standard = o.value("std").toString();
+    profile = o.value("profile").toString();
+    const QJsonObject profileFlags = o.value("profileFlags").toObject();
+    profileCxxflags = lmc_jsonStrings(profileFlags.value("cxxflags"));
+    profileLdflags = lmc_jsonStrings(profileFlags.value("ldflags"));
+    cxxflags = lmc_jsonStrings(o.value("cxxflags"));
+    defines = lmc_jsonStrings(o.value("defines"));
+    ldflags = lmc_jsonStrings(o.value("ldflags"));
+    libs = lmc_jsonStrings(o.value("libs"));
+
+    // plain "dir" or "-Idir" lines are pinned to the project folder, anything fancier is kept
+    includeDirs.clear();
+    for (const QString &line : lmc_jsonStrings(o.value("includeDirs"))) {
+        const bool sw = line.startsWith("-I");
+        const QString dir = sw ? line.mid(2) : line;
+        if (dir.contains(' ') || dir.contains('=') || !QDir::isRelativePath(dir))
+            includeDirs << line;
+        else
+            includeDirs << (sw ? "-I" : "") + QDir::cleanPath(base.absoluteFilePath(dir));
+    }
+
+    // no "jobs": the job count suits a machine, not a project (QSettings, --jobs)
+    pch = o.value("pch").toBool(pch);
+    unity = o.value("unity").toBool(unity);
+    unityBatch = o.value("unityBatch").toInt(unityBatch);
+    timeTrace = o.value("timeTrace").toBool(timeTrace);
+    optRemarks = o.value("optRemarks").toBool(optRemarks);
+    linker = o.value("linker").toString(linker);
+    splitDwarf = o.value("splitDwarf").toBool(splitDwarf);
+    gdbIndex = o.value("gdbIndex").toBool(gdbIndex);
+    compressDebug = o.value("compressDebug").toBool(compressDebug);
+    thinLto = o.value("thinLto").toBool(thinLto);
+    pgoRuns = lmc_jsonStrings(o.value("pgoRuns"));
+    return true;
+}
+
+// sources and output are stored relative to the project file so the folder can move
+bool LmcBuildConfig::save(const QString &path) const
+{
+    const QDir base = QFileInfo(path).absoluteDir();
+    QJsonArray fileList;
+    for (const QString &file : files)
+        fileList << base.relativeFilePath(file);
+
+    QJsonObject o;
+    o.insert("files", fileList);
+    if (!output.isEmpty())
+        o.insert("output", base.relativeFilePath(output));
+    o.insert("compiler", compiler);
+    o.insert("std", standard);
+    o.insert("profile", profile);
+    if (!profile.isEmpty()) {
+        QJsonObject profileFlags;
+        profileFlags.insert("cxxflags", QJsonArray::fromStringList(profileCxxflags));
+        profileFlags.insert("ldflags", QJsonArray::fromStringList(profileLdflags));
+        o.insert("profileFlags", profileFlags);
+    }
+    o.insert("cxxflags", QJsonArray::fromStringList(cxxflags));
+    o.insert("includeDirs", QJsonArray::fromStringList(includeDirs));
+    o.insert("defines", QJsonArray::fromStringList(defines));
+    o.insert("ldflags", QJsonArray::fromStringList(ldflags));
+    o.insert("libs", QJsonArray::fromStringList(libs));
+    o.insert("pch", pch);
+    o.insert("unity", unity);
+    o.insert("unityBatch", unityBatch);
+    o.insert("timeTrace", timeTrace);
+    o.insert("optRemarks", optRemarks);
+    o.insert("linker", linker);
+    o.insert("splitDwarf", splitDwarf);
+    o.insert("gdbIndex", gdbIndex);
+    o.insert("compressDebug", compressDebug);
+    o.insert("thinLto", thinLto);
+    o.insert("pgoRuns", QJsonArray::fromStringList(pgoRuns));
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+    f.write(QJsonDocument(o).toJson());
+    return f.commit();
+}
+
+BuildEngine::BuildEngine(QObject *parent)
+    : QObject(parent)
+    , m_runner(new JobRunner(this))
+    , m_log(new LogSink(this))
+    , m_compileCache(new CompileCache)
+    , m_probes(new ProbeCache)
+    , m_scanner(new SourceScanner)
+    , m_trace(new BuildTrace)
+{
+    connect(m_runner, &JobRunner::jobStarted, this, [this](int index) {
+        const QString &label = m_runner->jobs().at(index).label;
+        m_trace->jobStarted(index, label);
+        emit jobStarted(label);
+    });
+    connect(m_runner, &JobRunner::jobOutput, this, &BuildEngine::onJobOutput);
+    connect(m_runner, &JobRunner::jobFinished, this, [this](int index, bool ok) {
+        m_trace->jobFinished(index, ok);
+    });
+    connect(m_runner, &JobRunner::jobFinished, this, &BuildEngine::onJobFinished);
+    connect(m_runner, &JobRunner::allFinished, this, &BuildEngine::onJobsFinished);
+    connect(m_runner, &JobRunner::jobStarted, this, &BuildEngine::reportProgress);
+    connect(m_runner, &JobRunner::jobFinished, this, &BuildEngine::reportProgress);
+    // fewer compiles side by side beat swapping, heavy template TUs take GBs each
+    m_runner->setMemoryAware(true);
+    connect(m_runner, &JobRunner::memoryStalled, this, [this](qint64 neededKb, qint64 spareKb) {
+        if (m_runner->memoryStalls() == 1)
+            appendLog(QString("⏳ Holding compiles back for memory: the next needs ~%1 MB, "
+                              "%2 MB to spare\n")
+                          .arg(neededKb / 1024)
+                          .arg(spareKb / 1024));
+    });
+
+    // shared with the window's Build menu, which writes these
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    m_compileCache->setEnabled(settings.value("compileCache", true).toBool());
+    m_compileCache->setMaxBytes(settings.value("cacheMaxMB", 2048).toLongLong() * 1024 * 1024);
+}
+
+BuildEngine::~BuildEngine()
+{
+    delete m_run;
+    delete m_compileCache;
+    delete m_probes;
+    delete m_scanner;
+    delete m_trace;
+}
+
+// auto-detect helpers (SDL2, GLFW, SFML)
+static bool lmc_containsSwitch(const QStringList &xs, const QString &needlePrefix)
+{
+    for (const QString &x : xs)
+        if (x.startsWith(needlePrefix))
+            return true;
+    return false;
+}
+
+QStringList lmc_splitArgs(const QString &s)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+    return QProcess::splitCommand(s);
+#else
+    return s.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+#endif
+}
+
+// pkg-config: returns {cflags, libs}
+static QPair<QStringList, QStringList> lmc_pkgConfigFlags(ProbeCache &probes, const QString &pkg)
+{
+    QStringList cflags, libs;
+#ifndef Q_OS_WIN
+    const QString c = probes.result("pkg-config --cflags " + pkg);
+    const QString l = probes.result("pkg-config --libs " + pkg);
+    if (!c.isEmpty())
+        cflags = lmc_splitArgs(c);
+    if (!l.isEmpty())
+        libs = lmc_splitArgs(l);
+#endif
+    return {cflags, libs};
+}
+
+// foo-config (sdl2-config and friends): returns {cflags, libs}
+static QPair<QStringList, QStringList> lmc_configToolFlags(ProbeCache &probes, const QString &tool)
+{
+#ifndef Q_OS_WIN
+    QStringList c, l;
+    const QString cstr = probes.result(tool + " --cflags");
+    const QString lstr = probes.result(tool + " --libs");
+    if (!cstr.isEmpty())
+        c = lmc_splitArgs(cstr);
+    if (!lstr.isEmpty())
+        l = lmc_splitArgs(lstr);
+    return {c, l};
+#else
+    Q_UNUSED(probes)
+    Q_UNUSED(tool)
+    return {};
+#endif
+}
+
+static void lmc_addIfMissing(QStringList &dest, const QStringList &src)
+{
+    for (const QString &s : src)
+        if (!dest.contains(s))
+            dest << s;
+}
+
+static void lmc_addWindowsEnvDir(const LmcLibrary &lib,
+            QStringList &incSwitches,
+            QStringList &ldflags,
+            QStringList &libs)
+{
+#ifdef Q_OS_WIN
+    if (lib.winEnvDir.isEmpty())
+        return;
+    const QString dir = qEnvironmentVariable(qPrintable(lib.winEnvDir));
+    if (!dir.isEmpty()) {
+        const QString inc = dir + "/include";
+        const QString libDir = dir + "/lib";
+        if (!lmc_containsSwitch(incSwitches, "-I" + inc))
+            incSwitches << ("-I" + inc);
+        if (!ldflags.contains("-L" + libDir))
+            ldflags << ("-L" + libDir);
+        lmc_addIfMissing(libs, lib.winLibs);
+    }
+#else
+    Q_UNUSED(lib)
+    Q_UNUSED(incSwitches)
+    Q_UNUSED(ldflags)
+    Q_UNUSED(libs)
+#endif
+}
+
+static void lmc_addMacBrewFallback(ProbeCache &probes,
+            const QString &pkg,
+            QStringList &incSwitches,
+            QStringList &ldflags)
+{
+#ifdef Q_OS_MAC
+    const QString prefix = probes.result("brew --prefix " + pkg);
+    if (!prefix.isEmpty()) {
+        const QString inc = prefix + "/include";
+        const QString lib = prefix + "/lib";
+        if (!lmc_containsSwitch(incSwitches, "-I" + inc))
+            incSwitches << ("-I" + inc);
+        if (!ldflags.contains("-L" + lib))
+            ldflags << ("-L" + lib);
+    }
+#endif
+}
+
+
+bool BuildEngine::start(const LmcBuildConfig &config)
+{
+    if (m_run)
+        return false;
+    m_exitCode = 1;
+    m_trace->begin();
+
+    QString out = config.output.trimmed();
+    if (out.isEmpty()) {
+        fail("❌ Please choose an output path.\n");
+        return false;
+    }
+    out = targetPathWithExt(out);
+    m_log->setSpillFile(QDir(buildDirForTarget(out)).absoluteFilePath("build.log"));
+
+    LmcProfile profile;
+    if (!config.profile.isEmpty()) {
+        // this machine's definition first, then the copy the project file carries
+        const QVector<LmcProfile> profiles = lmc_loadProfiles();
+        const int index = lmc_findProfile(profiles, config.profile);
+        if (index >= 0) {
+            profile = profiles.at(index);
+            appendLog("Profile: " + profile.name + "\n");
+        } else if (!config.profileCxxflags.isEmpty() || !config.profileLdflags.isEmpty()) {
+            profile = LmcProfile{config.profile, config.profileCxxflags, config.profileLdflags};
+            appendLog("Profile: " + profile.name + " (as saved in the project)\n");
+        } else {
+            appendLog("⚠️ No build profile called \"" + config.profile
+                      + "\" here, building without it.\n");
+        }
+    }
+
+    // get src files
+    QStringList sources;
+    for (const QString &path : config.files) {
+        if (path.endsWith(".c", Qt::CaseInsensitive) || path.endsWith(".cc", Qt::CaseInsensitive)
+            || path.endsWith(".cpp", Qt::CaseInsensitive)) {
+            sources << path;
+        }
+    }
+    if (sources.isEmpty()) {
+        fail("❌ Add at least one source file.\n");
+        return false;
+    }
+
+    // one pass over every source: main() detection + includes for library auto-detection
+    m_trace->phase("scan");
+    const QVector<LmcSourceInfo> scanned = m_scanner->scan(sources);
+    if (m_scanner->scanned() > 0)
+        appendLog(QString("Scanned %1 source(s), %2 unchanged\n")
+                      .arg(m_scanner->scanned())
+                      .arg(m_scanner->reused()));
+
+    m_scanner->commit();
+
+    // check for multiple main() functions (mostly for me because i'm a doughnut)
+    QStringList mainFiles;
+    for (int i = 0; i < sources.size(); ++i)
+        if (scanned.at(i).hasMain)
+            mainFiles << QFileInfo(sources.at(i)).fileName();
+
+    if (mainFiles.size() > 1) {
+        appendLog("⚠️ Multiple main() functions found:\n");
+        for (const QString &f : mainFiles)
+            appendLog("   - " + f + "\n");
+        fail("❌ Only one main() is allowed per program. Please deselect extra files.\n");
+        return false;
+    }
+
+    // flags from the front end, one line each
+    const QStringList &cxxLines = config.cxxflags;
+    const QStringList &incLines = config.includeDirs;
+    const QStringList &defLines = config.defines;
+    const QStringList &ldLines = config.ldflags;
+    const QStringList &libLines = config.libs;
+
+    // split like shell, accept "VAR = ..." style
+    auto stripMakeVar = [](const QString &line) -> QString {
+        int eq = line.indexOf('=');
+        if (eq >= 0)
+            return line.mid(eq + 1).trimmed();
+        return line.trimmed();
+    };
+    auto linesToArgs = [&](const QStringList &lines) -> QStringList {
+        QStringList args;
+        for (const QString &ln : lines) {
+            const QString s = stripMakeVar(ln);
+            if (!s.isEmpty())
+                args << lmc_splitArgs(s);
+        }
+        return args;
+    };
+
+    QStringList cxxflags = linesToArgs(cxxLines);
+    QStringList incs = linesToArgs(incLines);
+    QStringList defs = linesToArgs(defLines);
+    QStringList ldflags = linesToArgs(ldLines);
+    QStringList libs = linesToArgs(libLines);
+
+    // profile flags first so the boxes can still override them. plain flags, no VAR = form
+    for (int i = profile.cxxflags.size() - 1; i >= 0; --i)
+        cxxflags = lmc_splitArgs(profile.cxxflags.at(i)) + cxxflags;
+    for (int i = profile.ldflags.size() - 1; i >= 0; --i)
+        ldflags = lmc_splitArgs(profile.ldflags.at(i)) + ldflags;
+
+    // normalize -I / -D for bare values
+    QStringList incSwitches;
+    for (auto &i : incs)
+        incSwitches << (i.startsWith("-I") ? i : "-I" + i);
+    QStringList defSwitches;
+    for (auto &d : defs)
+        defSwitches << (d.startsWith("-D") ? d : "-D" + d);
+
+    // C++ standard
+    const QString &stdSel = config.standard;
+    if (stdSel.startsWith("c++"))
+        cxxflags << ("-std=" + stdSel);
+
+    m_trace->phase("detect");
+    // flag auto-detection logic: follow the project's own headers, then map every
+    // include through the library table (libraries.json + the user's override)
+    QStringList includeDirs;
+    for (const QString &sw : std::as_const(incSwitches))
+        includeDirs << sw.mid(2);
+    const QSet<QString> includes = m_scanner->includeClosure(sources, scanned, includeDirs);
+    m_inputs.clear();
+    for (const QString &src : std::as_const(sources))
+        m_inputs << QFileInfo(src).absoluteFilePath();
+    m_inputs << m_scanner->headerPaths();
+    m_scanner->commit();
+
+    const LibraryRegistry registry;
+    const QVector<LmcLibrary> detected = registry.detect(includes);
+    if (!detected.isEmpty()) {
+        QStringList names;
+        for (const LmcLibrary &lib : detected)
+            names << lib.name;
+        appendLog(QString("Detected %1 (%2 project header(s) followed)\n")
+                      .arg(names.join(", "))
+                      .arg(m_scanner->headersWalked()));
+    }
+
+    QString compiler = config.compiler.trimmed();
+    if (compiler.isEmpty())
+        compiler = defaultCompiler();
+    // every profile keeps its own objects, stamps, pch and unity batches. so do both PGO
+    // builds, or each PGO run would leave the everyday objects to be rebuilt from scratch
+    QString buildDir = buildDirForTarget(out);
+    QString dirName = profile.name;
+    if (config.profileGenerate || !config.profileUse.isEmpty())
+        dirName += QString(dirName.isEmpty() ? "" : "-")
+                   + (config.profileGenerate ? "pgo-gen" : "pgo-use");
+    if (!dirName.isEmpty()) {
+        buildDir = lmc_profileBuildDir(buildDir, dirName);
+        QDir().mkpath(buildDir);
+    }
+
+    m_run = new LmcBuildRun;
+    m_run->out = out;
+    m_run->buildDir = buildDir;
+    m_run->compiler = compiler;
+    m_run->config = config;
+    m_run->sources = sources;
+    m_run->scanned = scanned;
+    m_run->detected = detected;
+    m_run->cxxflags = cxxflags;
+    m_run->incSwitches = incSwitches;
+    m_run->defSwitches = defSwitches;
+    m_run->ldflags = ldflags;
+    m_run->libs = libs;
+
+    // warm every probe up front: cached answers cost a stat(), misses run as jobs side by side
+    m_trace->phase("probe");
+    m_probes->beginBuild();
+    m_run->phase = LmcBuildRun::Probe;
+    startProbes();
+    return true;
+}
+
+// one round of probe misses (plus the compiler's --version the compile cache keys on) as
+// jobs, so a slow brew or pkg-config never holds up the GUI. planBuild() once none are left
+void BuildEngine::startProbes()
+{
+    m_run->probing = m_probes->pending(LibraryRegistry::probeCommands(m_run->detected));
+    QVector<LmcJob> jobs;
+    for (const QString &cmd : std::as_const(m_run->probing)) {
+        LmcJob job;
+        job.label = cmd;
+        job.program = "/bin/sh";
+        job.args << "-c" << cmd;
+        job.stdoutOnly = true;
+        jobs << job;
+    }
+    if (!m_run->versionAsked && m_compileCache->isEnabled()
+        && m_compileCache->compilerId(m_run->compiler).isEmpty()) {
+        LmcJob job;
+        job.label = QFileInfo(m_run->compiler).fileName() + " --version";
+        job.program = m_run->compiler;
+        job.args << "--version";
+        job.stdoutOnly = true;
+        jobs << job;
+        m_run->versionAsked = true;
+    }
+    if (jobs.isEmpty()) {
+        planBuild();
+        return;
+    }
+    m_runner->setMaxJobs(jobs.size());
+    m_runner->setKeepGoing(true);
+    m_runner->start(jobs);
+}
+
+// everything start() gathered plus the probe answers -> flags, the jobs, then the first batch
+void BuildEngine::planBuild()
+{
+    const LmcBuildConfig &config = m_run->config;
+    const QStringList &sources = m_run->sources;
+    const QVector<LmcSourceInfo> &scanned = m_run->scanned;
+    const QVector<LmcLibrary> &detected = m_run->detected;
+    const QString &compiler = m_run->compiler;
+    const QString &buildDir = m_run->buildDir;
+    QStringList cxxflags = m_run->cxxflags;
+    QStringList incSwitches = m_run->incSwitches;
+    const QStringList &defSwitches = m_run->defSwitches;
+    QStringList ldflags = m_run->ldflags;
+    QStringList libs = m_run->libs;
+
+    if (m_probes->hits() + m_probes->runs() > 0)
+        appendLog(QString("Probes: %1 cached, %2 run\n")
+                      .arg(m_probes->hits())
+                      .arg(m_probes->runs()));
+
+    for (const LmcLibrary &lib : detected) {
+        if (!lib.config.isEmpty()) {
+            auto P = lmc_configToolFlags(*m_probes, lib.config);
+            lmc_addIfMissing(cxxflags, P.first);
+            lmc_addIfMissing(libs, P.second);
+        }
+        for (const QString &pkg : lib.pkgconfig) {
+            auto P = lmc_pkgConfigFlags(*m_probes, pkg);
+            lmc_addIfMissing(cxxflags, P.first);
+            lmc_addIfMissing(libs, P.second);
+        }
+#ifdef Q_OS_MAC
+        // a library with Homebrew include dirs of its own (SDL2) needs no fallback when its
+        // config tool already pointed at a Homebrew prefix
+        const bool brewInFlags = !lib.macIncludeDirs.isEmpty()
+                                 && (lmc_containsSwitch(cxxflags, "-I/opt/homebrew/include")
+                                     || lmc_containsSwitch(cxxflags, "-I/usr/local/include"));
+        if (!lib.brew.isEmpty() && !brewInFlags)
+            lmc_addMacBrewFallback(*m_probes, lib.brew, incSwitches, ldflags);
+        for (const QString &dir : lib.macIncludeDirs) {
+            if (!brewInFlags && !lmc_containsSwitch(incSwitches, "-I" + dir))
+                incSwitches << ("-I" + dir);
+        }
+        for (const QString &dir : lib.macLibDirs) {
+            if (!ldflags.contains("-L" + dir))
+                ldflags << ("-L" + dir);
+        }
+#endif
+        lmc_addWindowsEnvDir(lib, incSwitches, ldflags, libs);
+    }
+
+    // ensure link when flimsy auto-detect can't find pkg-config/sdl2-config.
+    // walk backwards so dependents (-lSDL2_ttf) land before what they need (-lSDL2)
+    for (int i = detected.size() - 1; i >= 0; --i)
+        lmc_addIfMissing(libs, detected.at(i).libs);
+
+    m_trace->phase("plan");
+
+    // compile: one -c per TU into build/, up to config.jobs at once.
+    // an object is reused while its flags, source and every header from its depfile are unchanged
+    QStringList compileFlags;
+    if (config.thinLto)
+        compileFlags << "-O2" << "-DNDEBUG" << "-flto=thin"; // cxxflags can still override -O
+    compileFlags << cxxflags << incSwitches << defSwitches;
+    // clang writes <object>.json next to every object, read back in finishBuild()
+    if (config.timeTrace)
+        compileFlags << "-ftime-trace";
+    // <object>.opt.yaml next to every object, read back in finishBuild()
+    if (config.optRemarks)
+        compileFlags << "-fsave-optimization-record";
+    if (config.profileGenerate)
+        compileFlags << "-fprofile-instr-generate";
+
+    // lld/mold via -fuse-ld, and lighter debug info for the edit-link loop
+    QString linkerNote;
+    const QVector<LmcLinker> linkers = lmc_findLinkers(compiler);
+    LmcLinker ld = lmc_pickLinker(linkers, config.linker, &linkerNote);
+#ifndef Q_OS_MAC
+    // outside ld64, the system linker only does LTO with a plugin that's often missing
+    if (config.thinLto && ld.name.isEmpty()) {
+        for (const LmcLinker &l : linkers) {
+            if (l.name == "lld") {
+                ld = l;
+                linkerNote = l.name + " (" + l.path + "), for ThinLTO";
+            }
+        }
+    }
+#endif
+    QStringList linkerFlags;
+    if (!ld.fuseLd.isEmpty())
+        linkerFlags << ("-fuse-ld=" + ld.fuseLd);
+    // modules whose summary and imports didn't change come out of the cache, not the optimizer.
+    // clean() leaves the cache alone, it prunes itself
+    const QString ltoCacheDir = QDir(buildDir).absoluteFilePath("thinlto-cache");
+    if (config.thinLto)
+        linkerFlags << "-O2" << "-flto=thin" << lmc_thinLtoCacheFlags(ld, ltoCacheDir, kLtoCacheMB);
+    if (config.profileGenerate)
+        linkerFlags << "-fprofile-instr-generate"; // pulls in the profile runtime
+#if !defined(Q_OS_MAC) && !defined(Q_OS_WIN)
+    bool debugInfo = false;
+    for (const QString &f : std::as_const(cxxflags))
+        if (f.startsWith("-g") && f != "-g0")
+            debugInfo = true;
+    if (debugInfo && config.splitDwarf)
+        compileFlags << "-gsplit-dwarf";
+    if (debugInfo && config.compressDebug) {
+        compileFlags << "-gz";
+        linkerFlags << "-gz";
+    }
+    if (debugInfo && config.gdbIndex) {
+        if (!ld.name.isEmpty())
+            linkerFlags << "-Wl,--gdb-index";
+        else
+            linkerNote += ", --gdb-index skipped (needs lld or mold)";
+    }
+#endif
+
+    m_run->timeTrace = config.timeTrace;
+    m_run->optRemarks = config.optRemarks;
+    m_run->history = lmc_readTuHistory(buildDir);
+    for (int i = 0; i < sources.size(); ++i)
+        m_run->weights.insert(sources.at(i),
+                              lmc_compileWeight(QFileInfo(sources.at(i)).size(),
+                                                scanned.at(i).systemIncludes.size()
+                                                    + scanned.at(i).localIncludes.size()));
+
+    // PCH mode: the <...> headers most TUs share get parsed once, into build/lmc_pch.hpp.pch,
+    // rebuilt only when the header list, the flags or anything the headers pull in changes
+    QHash<QString, qint64> mtimes;
+    QStringList cacheFlags = compileFlags;
+    bool pchDirty = false;
+    const QStringList pchHeaders = config.pch ? lmc_pickPchHeaders(scanned) : QStringList();
+    if (!pchHeaders.isEmpty()) {
+        m_run->pchTu = lmc_writePchHeader(buildDir, pchHeaders);
+        m_run->pchSig = lmc_signature(compiler, compileFlags);
+        const QString reason = lmc_dirtyReason(m_run->pchTu, m_run->pchSig, mtimes);
+        pchDirty = !reason.isEmpty();
+        appendLog(QString("Precompiled header: %1 (%2)\n")
+                      .arg(pchHeaders.join(", "), pchDirty ? reason : QString("up to date")));
+
+        m_run->pchJob.label = QFileInfo(m_run->pchTu.obj).fileName();
+        m_run->pchJob.program = compiler;
+        m_run->pchJob.args << "-x" << "c++-header" << m_run->pchTu.src << "-o" << m_run->pchTu.obj
+                         << "-MD" << "-MF" << m_run->pchTu.dep
+                         << "--serialize-diagnostics" << m_run->pchTu.dia
+                         << lmc_responseArgs(QDir(buildDir).absoluteFilePath("lmc_pch.rsp"),
+                                             compileFlags);
+        m_run->pchJob.memoryKb = m_run->history.value(m_run->pchTu.src).peakRssKb;
+        m_run->pchJob.expectedMs = m_run->history.value(m_run->pchTu.src).compileMs;
+        compileFlags << "-include-pch" << m_run->pchTu.obj;
+
+        // cached objects depend on what went into the .pch, not on where it lives. no
+        // depfile yet (first PCH build) means nothing to key on, so skip the cache once.
+        QByteArray pchDigest;
+        if (m_compileCache->isEnabled())
+            pchDigest = m_compileCache->digestOf(lmc_readDepFile(m_run->pchTu.dep));
+        cacheFlags << ("-include-pch=" + QString::fromLatin1(pchDigest));
+        if (pchDigest.isEmpty())
+            cacheFlags.clear();
+    }
+    // PGO: a retrained profile at the same path has to recompile everything, so the
+    // signature and the cache key see the profile's contents instead of its path
+    QStringList sigFlags = compileFlags;
+    if (!config.profileUse.isEmpty()) {
+        const QStringList warnings{"-Wprofile-instr-out-of-date", "-Wprofile-instr-missing"};
+        const QByteArray profile = m_compileCache->digestOf({config.profileUse});
+        compileFlags << ("-fprofile-instr-use=" + config.profileUse) << warnings;
+        sigFlags = compileFlags;
+        sigFlags << ("-fprofile-instr-use=" + QString::fromLatin1(profile));
+        if (!cacheFlags.isEmpty())
+            cacheFlags << ("-fprofile-instr-use=" + QString::fromLatin1(profile)) << warnings;
+        if (profile.isEmpty())
+            cacheFlags.clear();
+    }
+    const QByteArray compileSig = lmc_signature(compiler, sigFlags);
+    m_run->compileSig = compileSig;
+    // thousands of -I/-D can outgrow a command line, every TU then reads them from one file
+    m_run->compileFlags = lmc_responseArgs(QDir(buildDir).absoluteFilePath("lmc_compile.rsp"),
+                                           compileFlags);
+
+    // dirty TUs try the shared compile cache before a compiler is spawned
+    m_compileCache->beginBuild();
+    // a cached object comes without its remarks file or time trace, so those builds always
+    // compile. same for split DWARF: the .o's skeleton points at a .dwo the cache doesn't keep
+    const QByteArray compilerId = m_compileCache->compilerId(compiler); // empty: --version failed
+    const bool useCache = m_compileCache->isEnabled() && !cacheFlags.isEmpty()
+                          && !compilerId.isEmpty() && !config.optRemarks && !config.timeTrace
+                          && !compileFlags.contains("-gsplit-dwarf");
+    if (useCache) {
+        m_run->cacheFlags = cacheFlags;
+        m_run->compilerId = compilerId;
+    }
+
+    // unity mode: sources go through generated batch files, except the ones that broke a
+    // batch before and whatever is left over alone
+    QVector<LmcUnityBatch> units;
+    QStringList standalone;
+    if (config.unity) {
+        const QSet<QString> skip = lmc_readUnitySkip(buildDir);
+        QStringList batchable;
+        for (const QString &src : sources) {
+            if (skip.contains(QFileInfo(src).absoluteFilePath()))
+                standalone << src;
+            else
+                batchable << src;
+        }
+        units = lmc_planUnity(buildDir, batchable, config.unityBatch, config.jobs, &standalone);
+        for (const LmcUnityBatch &batch : std::as_const(units))
+            lmc_writeUnityBatch(batch);
+        if (!units.isEmpty())
+            appendLog(QString("Unity build: %1 source(s) in %2 batch(es), %3 standalone\n")
+                          .arg(sources.size() - standalone.size())
+                          .arg(units.size())
+                          .arg(standalone.size()));
+    } else {
+        standalone = sources;
+    }
+    for (const QString &src : std::as_const(standalone))
+        units << LmcUnityBatch{src, {}};
+
+    int restored = 0;
+    for (const LmcUnityBatch &unit : std::as_const(units)) {
+        const QString &src = unit.file;
+        const LmcTuFiles tu = lmc_tuFiles(src, objectPathFor(buildDir, src));
+        m_run->objects << tu.obj;
+        // up-to-date TUs still tell how fast this project compiles
+        m_run->estimate.addTimed(unitWeight(unit), m_run->history.value(src).compileMs);
+
+        QString reason = lmc_dirtyReason(tu, compileSig, mtimes);
+        if (reason.isEmpty() && pchDirty)
+            reason = "precompiled header changed";
+        if (reason.isEmpty())
+            continue;
+
+        QByteArray key;
+        if (useCache) {
+            key = m_compileCache->keyFor(compilerId, cacheFlags, src);
+            if (m_compileCache->fetch(key, tu)) {
+                lmc_writeStamp(tu.stamp, compileSig);
+                ++restored;
+                continue;
+            }
+        }
+
+        LmcJob job;
+        job.label = QFileInfo(src).fileName() + " (" + reason + ")";
+        if (!unit.sources.isEmpty())
+            job.label += QString(", %1 sources").arg(unit.sources.size());
+        job.program = compiler;
+        job.args << "-c" << src << "-o" << tu.obj << "-MD" << "-MF" << tu.dep
+                 << "--serialize-diagnostics" << tu.dia << m_run->compileFlags;
+        job.memoryKb = m_run->history.value(src).peakRssKb;
+        m_run->jobs << job;
+        m_run->jobTus << tu;
+        m_run->jobKeys << key;
+        m_run->jobBatches << unit;
+    }
+    m_run->objectsChanged = !m_run->jobs.isEmpty() || restored > 0;
+    for (int i = 0; i < m_run->jobs.size(); ++i)
+        m_run->jobs[i].expectedMs = expectedCompileMs(m_run->jobBatches.at(i));
+
+    // link once: clang++ objs -o out [flags], put together in startLink() since a unity
+    // fallback can still swap objects
+    m_run->linkFlags << linkerFlags << cxxflags << ldflags << libs;
+    m_flags = compileFlags + m_run->linkFlags;
+    m_run->linkerNote = linkerNote;
+    if (config.thinLto)
+        m_run->ltoCacheDir = ltoCacheDir;
+
+    m_runner->setMaxJobs(config.jobs);
+    // a broken batch is retried source by source, so don't let it stop the others
+    m_runner->setKeepGoing(config.unity);
+    if (restored > 0)
+        appendLog(QString("Restored %1 object(s) from the compile cache\n").arg(restored));
+    if (m_run->jobs.isEmpty())
+        appendLog(QString("All %1 object(s) up to date\n").arg(m_run->objects.size()));
+    else
+        appendLog(QString("Compiling %1 of %2 source(s) with %3 job(s)\n")
+                      .arg(m_run->jobs.size())
+                      .arg(m_run->objects.size())
+                      .arg(m_runner->maxJobs()));
+
+    for (const LmcTuFiles &tu : std::as_const(m_run->jobTus))
+        QFile::remove(tu.stamp);
+    // everything from here on is driven by JobRunner signals
+    if (pchDirty) {
+        QFile::remove(m_run->pchTu.stamp);
+        m_run->phase = LmcBuildRun::Pch;
+        m_trace->phase("pch");
+        m_runner->start({m_run->pchJob});
+    } else {
+        m_trace->phase("compile");
+        m_runner->start(m_run->jobs);
+    }
+}
+
+void BuildEngine::cancel()
+{
+    if (!m_run)
+        return;
+    appendLog("\nCancelling…\n");
+    m_runner->cancel();
+}
+
+void BuildEngine::onJobOutput(int index, const QString &chunk)
+{
+    Q_UNUSED(index)
+    appendLog(chunk);
+}
+
+void BuildEngine::onJobFinished(int index, bool ok, const QString &output)
+{
+    if (!m_run)
+        return;
+
+    if (m_run->phase == LmcBuildRun::Probe) {
+        if (m_runner->wasCancelled())
+            return;
+        if (index < m_run->probing.size())
+            m_probes->store(m_run->probing.at(index), output);
+        else if (ok)
+            m_compileCache->setCompilerVersion(m_run->compiler, output.toLocal8Bit());
+        return;
+    }
+
+    if (m_run->phase == LmcBuildRun::Link) {
+        appendLog(output);
+        return;
+    }
+
+    if (m_run->phase == LmcBuildRun::Pch) {
+        const LmcJob &job = m_run->pchJob;
+        if (ok) {
+            lmc_writeStamp(m_run->pchTu.stamp, m_run->pchSig);
+            noteCompile(m_run->pchTu.src, index);
+        }
+        appendLog(QString(ok ? "" : "❌ ") + job.label + "\n" + job.program + " "
+                  + job.args.join(" ") + "\n" + output);
+        readDiagnostics(m_run->pchTu.dia);
+        return;
+    }
+
+    const LmcJob &job = m_run->jobs.at(index);
+    const LmcTuFiles &tu = m_run->jobTus.at(index);
+    const LmcUnityBatch &batch = m_run->jobBatches.at(index);
+    if (!ok)
+        ++m_run->failed;
+    if (!ok && !batch.sources.isEmpty() && !m_runner->wasCancelled()) {
+        QFile::remove(tu.stamp);
+        QFile::remove(tu.dia); // the standalone retries report these again, per source
+        m_run->unityFailed << index;
+        for (const QString &src : lmc_unityCulprits(batch, output))
+            if (!m_run->unityCulprits.contains(src))
+                m_run->unityCulprits << src;
+        appendLog(QString("[%1/%2] ⚠️ %3 failed as a batch, its sources will be compiled "
+                          "standalone\n")
+                      .arg(++m_run->done)
+                      .arg(m_run->jobs.size())
+                      .arg(QFileInfo(batch.file).fileName()));
+        return;
+    }
+
+    // only a clean compile earns a stamp, anything else stays dirty
+    if (ok) {
+        lmc_writeStamp(tu.stamp, m_run->compileSig);
+        m_compileCache->store(m_run->jobKeys.at(index), tu);
+        noteCompile(batch.file, index);
+        // broke its batch, compiles alone: it only clashes with the others
+        if (batch.sources.isEmpty() && m_run->unityCulprits.contains(batch.file))
+            lmc_addUnitySkip(m_run->buildDir, {batch.file});
+    } else {
+        QFile::remove(tu.stamp);
+    }
+
+    // each TU's output arrives in one piece, so print it as a block
+    QString head = QString("[%1/%2] ").arg(++m_run->done).arg(m_run->jobs.size());
+    if (!ok)
+        head += "❌ ";
+    appendLog(head + job.label + "\n" + job.program + " " + job.args.join(" ") + "\n" + output);
+    readDiagnostics(tu.dia);
+}
+
+// a failed compile may have stopped short, only good ones are kept
+void BuildEngine::noteCompile(const QString &src, int index)
+{
+    LmcTuHistory &h = m_run->history[src];
+    const qint64 peak = m_runner->peakRssKb(index);
+    if (peak > 0) // 0: done before the first sample, too small to matter
+        h.peakRssKb = peak;
+    h.compileMs = qMax<qint64>(1, m_runner->durationMs(index));
+    m_run->historyChanged = true;
+}
+
+// a unity batch costs what its members do
+double BuildEngine::unitWeight(const LmcUnityBatch &unit) const
+{
+    if (unit.sources.isEmpty())
+        return m_run->weights.value(unit.file);
+    double weight = 0;
+    for (const QString &src : unit.sources)
+        weight += m_run->weights.value(src);
+    return weight;
+}
+
+qint64 BuildEngine::expectedCompileMs(const LmcUnityBatch &unit) const
+{
+    const qint64 timed = m_run->history.value(unit.file).compileMs;
+    return timed > 0 ? timed : m_run->estimate.estimateMs(unitWeight(unit));
+}
+
+// after every start and end of a compile, the window turns it into a progress bar
+void BuildEngine::reportProgress()
+{
+    if (m_run && m_run->phase == LmcBuildRun::Compile)
+        emit progress(m_run->done, m_run->jobs.size(), m_runner->remainingMs());
+}
+
+void BuildEngine::readDiagnostics(const QString &path)
+{
+    QVector<LmcDiagnostic> diags;
+    lmc_readDiagnostics(path, &diags); // whatever parsed before a truncated tail still counts
+    // gone before the next compile, so a crashed one can't replay these
+    QFile::remove(path);
+    if (!diags.isEmpty())
+        emit diagnostics(diags);
+}
+
+void BuildEngine::onJobsFinished(bool ok)
+{
+    if (!m_run)
+        return;
+
+    // a probe that fails is an answer too (no such package), only Cancel stops here
+    if (m_run->phase == LmcBuildRun::Probe) {
+        if (m_runner->wasCancelled()) {
+            finishBuild(false);
+            return;
+        }
+        m_probes->save();
+        startProbes();
+        return;
+    }
+    if (!ok)
+        m_exitCode = qMax(m_runner->failureCode(), 1);
+
+    if (m_run->phase == LmcBuildRun::Link) {
+        if (ok)
+            lmc_writeStamp(m_run->linkStamp, m_run->linkSig);
+        if (ok && !m_run->ltoCacheDir.isEmpty()) {
+            // one entry per module the optimizer had to run on, the rest were reused
+            int added = 0;
+            const QSet<QString> now = lmc_thinLtoCacheEntries(m_run->ltoCacheDir);
+            for (const QString &e : now)
+                if (!m_run->ltoCacheBefore.contains(e))
+                    ++added;
+            const int modules = m_run->objects.size();
+            appendLog(QString("ThinLTO cache: %1 of %2 modules reused, %3 optimized, %4 kept\n")
+                          .arg(qMax(0, modules - added))
+                          .arg(modules)
+                          .arg(added)
+                          .arg(now.size()));
+        }
+        finishBuild(ok);
+        return;
+    }
+
+    // the .pch is in place (or not), TUs go next
+    if (m_run->phase == LmcBuildRun::Pch) {
+        if (!ok) {
+            finishBuild(false);
+            return;
+        }
+        m_run->phase = LmcBuildRun::Compile;
+        m_trace->phase("compile");
+        m_runner->start(m_run->jobs);
+        return;
+    }
+
+    // every failure so far was a unity batch: retry those sources one by one
+    if (!m_run->unityFailed.isEmpty() && m_run->failed == m_run->unityFailed.size()
+        && !m_runner->wasCancelled()) {
+        startUnityFallback();
+        return;
+    }
+
+    if (m_compileCache->hits() + m_compileCache->misses() > 0)
+        appendLog(m_compileCache->endBuild());
+    if (m_runner->memoryStalls() > 0)
+        appendLog(QString("Memory: compiles were held back %1 time(s) to stay out of swap\n")
+                      .arg(m_runner->memoryStalls()));
+
+    if (!ok) {
+        finishBuild(false);
+        return;
+    }
+    startLink();
+}
+
+// members of broken batches get their own objects. a source the errors point at stays out
+// of future batches only once it compiles fine on its own, a plain typo doesn't count.
+// everything else is batched again next time.
+void BuildEngine::startUnityFallback()
+{
+    QVector<LmcJob> jobs;
+    QVector<LmcTuFiles> tus;
+    QVector<QByteArray> keys;
+    QVector<LmcUnityBatch> units;
+    QHash<QString, qint64> mtimes;
+    int members = 0;
+    QStringList proven; // culprits whose standalone object is already good
+    for (const int index : std::as_const(m_run->unityFailed)) {
+        m_run->objects.removeAll(m_run->jobTus.at(index).obj);
+        for (const QString &src : m_run->jobBatches.at(index).sources) {
+            const LmcTuFiles tu = lmc_tuFiles(src, objectPathFor(m_run->buildDir, src));
+            m_run->objects << tu.obj;
+            ++members;
+            // built standalone before and untouched since
+            if (lmc_dirtyReason(tu, m_run->compileSig, mtimes).isEmpty()) {
+                if (m_run->unityCulprits.contains(src))
+                    proven << src;
+                continue;
+            }
+
+            QByteArray key;
+            if (!m_run->cacheFlags.isEmpty()) {
+                key = m_compileCache->keyFor(m_run->compilerId, m_run->cacheFlags, src);
+                if (m_compileCache->fetch(key, tu)) {
+                    lmc_writeStamp(tu.stamp, m_run->compileSig);
+                    if (m_run->unityCulprits.contains(src))
+                        proven << src;
+                    continue;
+                }
+            }
+
+            LmcJob job;
+            job.label = QFileInfo(src).fileName() + " (unity fallback)";
+            job.program = m_run->compiler;
+            job.args << "-c" << src << "-o" << tu.obj << "-MD" << "-MF" << tu.dep
+                     << "--serialize-diagnostics" << tu.dia << m_run->compileFlags;
+            job.memoryKb = m_run->history.value(src).peakRssKb;
+            job.expectedMs = expectedCompileMs(LmcUnityBatch{src, {}});
+            jobs << job;
+            tus << tu;
+            keys << key;
+            units << LmcUnityBatch{src, {}};
+        }
+    }
+    appendLog(QString("Compiling %1 source(s) from %2 broken batch(es) standalone, %3 named "
+                      "by the errors\n")
+                  .arg(members)
+                  .arg(m_run->unityFailed.size())
+                  .arg(m_run->unityCulprits.size()));
+    if (!proven.isEmpty())
+        lmc_addUnitySkip(m_run->buildDir, proven);
+
+    m_run->jobs = jobs;
+    m_run->jobTus = tus;
+    m_run->jobKeys = keys;
+    m_run->jobBatches = units;
+    m_run->unityFailed.clear();
+    m_run->done = 0;
+    m_run->failed = 0;
+    m_run->objectsChanged = true;
+    for (const LmcTuFiles &tu : std::as_const(m_run->jobTus))
+        QFile::remove(tu.stamp);
+    m_runner->setKeepGoing(false);
+    m_runner->start(m_run->jobs);
+}
+
+void BuildEngine::startLink()
+{
+    const QString &out = m_run->out;
+    m_run->linkArgs = m_run->objects;
+    m_run->linkArgs << "-o" << out << m_run->linkFlags;
+
+    // relink only when an object was rebuilt, the link line changed or the target is missing/stale
+    m_run->linkSig = lmc_signature(m_run->compiler, m_run->linkArgs);
+    // one stamp per target, not per profile: the target holds whichever profile linked last
+    const QDir targetDir(buildDirForTarget(out));
+    m_run->linkStamp = targetDir.absoluteFilePath(QFileInfo(out).fileName() + ".link.sig");
+    bool linkNeeded = m_run->objectsChanged || lmc_readStamp(m_run->linkStamp) != m_run->linkSig;
+    if (!linkNeeded) {
+        const QFileInfo outInfo(out);
+        if (!outInfo.exists()) {
+            linkNeeded = true;
+        } else {
+            for (const QString &obj : std::as_const(m_run->objects)) {
+                if (QFileInfo(obj).lastModified() > outInfo.lastModified()) {
+                    linkNeeded = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!linkNeeded) {
+        appendLog("Link skipped, " + QFileInfo(out).fileName() + " is up to date\n");
+        finishBuild(true);
+        return;
+    }
+
+    LmcJob link;
+    link.label = QFileInfo(out).fileName();
+    link.program = m_run->compiler;
+    // 10,000 objects don't fit on any command line, clang++ takes them from a file
+    link.args = lmc_responseArgs(QDir(m_run->buildDir).absoluteFilePath("lmc_link.rsp"),
+                                 m_run->linkArgs);
+
+    appendLog("Linker: " + m_run->linkerNote + "\n");
+    appendLog("Command: " + m_run->compiler + " " + link.args.join(" ") + "\n");
+    link.stream = true;
+
+    if (!m_run->ltoCacheDir.isEmpty()) {
+        QDir().mkpath(m_run->ltoCacheDir);
+        m_run->ltoCacheBefore = lmc_thinLtoCacheEntries(m_run->ltoCacheDir);
+    }
+
+    QFile::remove(m_run->linkStamp);
+    m_run->phase = LmcBuildRun::Link;
+    m_trace->phase("link");
+    m_runner->start({link});
+}
+
+void BuildEngine::finishBuild(bool ok)
+{
+    const QString out = m_run->out;
+    const bool cancelled = m_runner->wasCancelled();
+
+    if (m_run->timeTrace && !cancelled) {
+        m_trace->phase("time trace");
+        QStringList traced = m_run->objects;
+        if (!m_run->pchTu.obj.isEmpty())
+            traced.prepend(m_run->pchTu.obj);
+        appendLog(lmc_timeTraceReport(traced,
+                                      QDir(m_run->buildDir).absoluteFilePath("time-trace.json")));
+    }
+
+    // up-to-date objects still have theirs from the compile that made them
+    if (m_run->optRemarks && !cancelled) {
+        m_trace->phase("remarks");
+        QVector<LmcRemark> remarks;
+        for (const QString &obj : std::as_const(m_run->objects))
+            lmc_readRemarks(lmc_remarksPath(obj), &remarks);
+        appendLog(lmc_remarksSummary(remarks));
+        emit optimizationRemarks(remarks);
+    }
+
+    if (m_run->historyChanged)
+        lmc_writeTuHistory(m_run->buildDir, m_run->history);
+
+    // one track per job slot, loads in chrome://tracing and Perfetto
+    m_trace->end();
+    m_timing = m_trace->summary();
+    const QString tracePath = QDir(m_run->buildDir).absoluteFilePath("trace.json");
+    appendLog("Timing: " + m_timing + "\n");
+    if (m_trace->write(tracePath))
+        appendLog("Trace: " + tracePath + "\n");
+
+    delete m_run;
+    m_run = nullptr;
+
+    if (!ok) {
+        appendLog(cancelled ? "⚠️ Build cancelled.\n" : "❌ Build failed.\n");
+        emit finished(false, out);
+        endLog();
+        return;
+    }
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_WIN)
+    QFile::setPermissions(out, QFile::permissions(out) | QFileDevice::ExeUser);
+#endif
+
+    m_exitCode = 0;
+    appendLog("✅ Build succeeded. Output: " + out + "\n");
+    emit finished(true, out);
+    endLog();
+}
+
+// a build that never got going: say why and close build.log
+void BuildEngine::fail(const QString &message)
+{
+    appendLog(message);
+    endLog();
+}
+
+void BuildEngine::appendLog(const QString &s)
+{
+    m_log->append(s);
+}
+
+// push out whatever is pending and close build.log
+void BuildEngine::endLog()
+{
+    m_log->flush();
+    m_log->setSpillFile(QString());
+}
+
+void BuildEngine::clean(const LmcBuildConfig &config)
+{
+    QString out = config.output.trimmed();
+    if (out.isEmpty()) {
+        appendLog("ℹ️ Nothing to clean (no target set).\n");
+        return;
+    }
+
+    // normalize same ruleset as build (no .out on macOS/Linux(Unix))
+    out = targetPathWithExt(out);
+
+    if (QFile::exists(out)) {
+        if (QFile::remove(out))
+            appendLog("Removed: " + out + "\n");
+        else
+            appendLog("⚠️ Could not remove: " + out + "\n");
+    } else {
+        appendLog("ℹ️ No file at: " + out + "\n");
+    }
+
+    // drop objects, depfiles and stamps so the next build starts from scratch, for every profile.
+    // build/ is a common name, so only what objectPathFor() and the pipeline name is touched
+    static const QRegularExpression objectFile(
+        "^.+-[0-9a-f]{8}\\.(o|d|dia|dwo|sig|json|opt\\.yaml)$");
+    const auto ours = [](const QString &name) {
+        if (name.startsWith("lmc_"))
+            return !name.endsWith(".history"); // tu timings and benchmark runs outlive a clean
+        return objectFile.match(name).hasMatch() || name.endsWith(".link.sig")
+               || name == "trace.json" || name == "time-trace.json";
+    };
+    const QString top = QFileInfo(out).dir().absoluteFilePath("build");
+    QStringList dirs{top};
+    const QDir profilesDir(top + "/profiles");
+    for (const QString &name : profilesDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+        dirs << profilesDir.absoluteFilePath(name);
+    for (const QString &path : std::as_const(dirs)) {
+        QDir buildDir(path);
+        if (!buildDir.exists())
+            continue;
+        int removed = 0;
+        for (const QString &name : buildDir.entryList(QDir::Files))
+            if (ours(name) && buildDir.remove(name))
+                ++removed;
+        if (removed > 0)
+            appendLog(QString("Removed %1 intermediate file(s) from %2\n")
+                          .arg(removed)
+                          .arg(buildDir.absolutePath()));
+    }
+
+    appendLog("Clean complete! \n");
+}
+
+QString BuildEngine::defaultCompiler()
+{
+#ifdef Q_OS_MAC
+    return "/usr/bin/clang++";
+#elif defined(Q_OS_WIN)
+    return "clang++.exe";
+#else
+    return "clang++";
+#endif
+}
+
+// MS Windows: .exe; macOS/Linux(Unix): **no extension** (strip .out if typed)
+QString BuildEngine::targetPathWithExt(QString out)
+{
+#ifdef Q_OS_WIN
+    if (!out.endsWith(".exe", Qt::CaseInsensitive))
+        out += ".exe";
+#else
+    if (out.endsWith(".out", Qt::CaseInsensitive))
+        out.chop(4);
+#endif
+    return out;
+}
+
+QString BuildEngine::buildDirForTarget(const QString &target)
+{
+    QFileInfo t(target);
+    QDir d = t.dir();
+    QString b = d.absoluteFilePath("build");
+    QDir().mkpath(b);
+    return b;
+}
+
+// build/<name>-<hash>.o, the path hash keeps same-named files from different folders apart
+QString BuildEngine::objectPathFor(const QString &buildDir, const QString &src)
+{
+    const QFileInfo fi(src);
+    const QByteArray h = QCryptographicHash::hash(fi.absoluteFilePath().toUtf8(),
+                                                  QCryptographicHash::Sha1)
+                             .toHex()
+                             .left(8);
+    return QDir(buildDir).absoluteFilePath(fi.completeBaseName() + "-" + QString::fromLatin1(h)
+                                           + ".o");
+}
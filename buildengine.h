@@ -0,0 +1,135 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QObject>
+#include <QStringList>
+#include "diagnostics.h"
+#include "remarks.h"
+
+class BuildTrace;
+class CompileCache;
+class JobRunner;
+class LogSink;
+class ProbeCache;
+class SourceScanner;
+struct LmcBuildRun;
+struct LmcUnityBatch;
+
+// everything a build needs from the front end: the main window's fields, or a
+// project file (*.lmcproj, JSON). list fields hold one entry per line of the
+// matching text box, exactly as typed.
+struct LmcBuildConfig
+{
+    QStringList files;   // anything that isn't .c/.cc/.cpp is ignored
+    QString compiler;    // empty: the platform's clang++
+    QString output;
+    QString standard;    // "c++17" and friends, anything else adds no -std
+    QString profile;     // name of an LmcProfile, empty: the flag boxes alone
+    // that profile's flags as saved with the project, used where it isn't set up (CI)
+    QStringList profileCxxflags;
+    QStringList profileLdflags;
+    QStringList cxxflags;
+    QStringList includeDirs;
+    QStringList defines;
+    QStringList ldflags;
+    QStringList libs;
+    int jobs = 1;        // per machine, never in the project file
+    bool pch = false;
+    bool unity = false;
+    int unityBatch = 0;  // sources per unity batch, 0 = automatic
+    bool timeTrace = false; // -ftime-trace + a ranked report at the end
+    bool optRemarks = false; // -fsave-optimization-record, what got missed and why
+    QString linker;      // "auto", "lld", "mold", else clang's default
+    // ELF debug builds (flags with -g) only
+    bool splitDwarf = false;    // -gsplit-dwarf, debug info stays in .dwo files
+    bool gdbIndex = false;      // -Wl,--gdb-index, needs lld or mold
+    bool compressDebug = false; // -gz
+    bool thinLto = false; // release: -O2 -DNDEBUG -flto=thin, LTO cache under the build dir
+    QStringList pgoRuns;  // PGO training runs, one line of program arguments each
+    // set by PgoWorkflow for one build, never saved
+    bool profileGenerate = false; // -fprofile-instr-generate
+    QString profileUse;           // merged .profdata for -fprofile-instr-use
+
+    // relative paths in the file (sources, output, include dirs) resolve against its folder
+    bool load(const QString &path, QString *error);
+    bool save(const QString &path) const;
+};
+
+// one line of flags or program arguments split like a shell would (plain whitespace before Qt 5.15)
+QStringList lmc_splitArgs(const QString &s);
+
+// the build pipeline with no widgets attached, shared by the window and --build:
+// scan -> detect libraries -> [pch ->] compile -> link, driven by JobRunner signals.
+// everything it has to say goes through logSink().
+class BuildEngine : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BuildEngine(QObject *parent = nullptr);
+    ~BuildEngine();
+
+    // false when there was nothing to start (why is in the log), finished() follows otherwise.
+    // finished() may fire before start() returns when everything is up to date.
+    bool start(const LmcBuildConfig &config);
+    void cancel();
+    bool isRunning() const { return m_run != nullptr; }
+    void clean(const LmcBuildConfig &config);
+
+    // 0 after a good build, the compiler's exit code when a compile or the link failed, else 1
+    int exitCode() const { return m_exitCode; }
+    // per-phase wall time of the last finished build, see BuildTrace
+    QString timingSummary() const { return m_timing; }
+    // sources and project headers the last start() read, what watch mode keeps an eye on
+    QStringList inputFiles() const { return m_inputs; }
+    // compile + link flags the last start() settled on, what benchmark runs are filed under
+    QStringList buildFlags() const { return m_flags; }
+
+    LogSink *logSink() const { return m_log; }
+    CompileCache *compileCache() const { return m_compileCache; }
+
+    static QString defaultCompiler();
+    static QString targetPathWithExt(QString out); // .exe on Windows, no .out elsewhere
+    static QString buildDirForTarget(const QString &target);
+
+signals:
+    void jobStarted(const QString &label);
+    // what one compile reported, parsed from clang's serialized diagnostics
+    void diagnostics(const QVector<LmcDiagnostic> &diags);
+    // every object's missed-optimization remarks, once the compiles are done
+    void optimizationRemarks(const QVector<LmcRemark> &remarks);
+    // compiles done out of total, and how long the rest should take going by earlier builds
+    void progress(int done, int total, qint64 remainingMs);
+    void finished(bool ok, const QString &target);
+
+private:
+    static QString objectPathFor(const QString &buildDir, const QString &src);
+
+    void appendLog(const QString &s);
+    void endLog();
+    void fail(const QString &message);
+
+    void startProbes();
+    void planBuild();
+    void onJobOutput(int index, const QString &chunk);
+    void onJobFinished(int index, bool ok, const QString &output);
+    void onJobsFinished(bool ok);
+    void noteCompile(const QString &src, int index);
+    double unitWeight(const LmcUnityBatch &unit) const;
+    qint64 expectedCompileMs(const LmcUnityBatch &unit) const;
+    void reportProgress();
+    void readDiagnostics(const QString &path);
+    void startUnityFallback();
+    void startLink();
+    void finishBuild(bool ok);
+
+    JobRunner *m_runner;
+    LogSink *m_log;
+    CompileCache *m_compileCache;
+    ProbeCache *m_probes;
+    SourceScanner *m_scanner;
+    BuildTrace *m_trace;
+    LmcBuildRun *m_run = nullptr; // non-null while a build is in flight
+    int m_exitCode = 0;
+    QString m_timing;
+    QStringList m_inputs;
+    QStringList m_flags;
+};
@@ -0,0 +1,141 @@
+// (c) 2025 Stardust Softworks
+#include "buildtrace.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStringList>
+
+static QString lmc_formatMicros(qint64 us)
+{
+    if (us < 1000 * 1000)
+        return QString("%1 ms").arg(us / 1000);
+    return QString("%1 s").arg(us / 1e6, 0, 'f', 2);
+}
+
+void BuildTrace::begin()
+{
+    m_spans.clear();
+    m_openJobs.clear();
+    m_busyTracks.clear();
+    m_phase = -1;
+    m_total = 0;
+    m_clock.start();
+}
+
+void BuildTrace::phase(const QString &name)
+{
+    const qint64 t = now();
+    if (m_phase >= 0)
+        m_spans[m_phase].duration = t - m_spans.at(m_phase).start;
+    Span s;
+    s.name = name;
+    s.start = t;
+    m_spans << s;
+    m_phase = m_spans.size() - 1;
+}
+
+void BuildTrace::end()
+{
+    const qint64 t = now();
+    if (m_phase >= 0)
+        m_spans[m_phase].duration = t - m_spans.at(m_phase).start;
+    m_phase = -1;
+    m_total = t;
+}
+
+void BuildTrace::jobStarted(int index, const QString &label)
+{
+    int track = m_busyTracks.indexOf(false);
+    if (track < 0) {
+        track = m_busyTracks.size();
+        m_busyTracks << true;
+    } else {
+        m_busyTracks[track] = true;
+    }
+
+    Span s;
+    s.name = label;
+    s.track = track + 1;
+    s.start = now();
+    m_spans << s;
+    m_openJobs.insert(index, m_spans.size() - 1);
+}
+
+void BuildTrace::jobFinished(int index, bool ok)
+{
+    auto it = m_openJobs.find(index);
+    if (it == m_openJobs.end())
+        return;
+    Span &s = m_spans[it.value()];
+    s.duration = now() - s.start;
+    s.ok = ok;
+    m_busyTracks[s.track - 1] = false;
+    m_openJobs.erase(it);
+}
+
+QString BuildTrace::summary() const
+{
+    // a phase can run twice (compile, unity fallback compile), add those up
+    QStringList order;
+    QHash<QString, qint64> totals;
+    for (const Span &s : m_spans) {
+        if (s.track != 0 || s.duration < 0)
+            continue;
+        if (!totals.contains(s.name))
+            order << s.name;
+        totals[s.name] += s.duration;
+    }
+
+    QStringList parts;
+    for (const QString &name : std::as_const(order))
+        parts << name + " " + lmc_formatMicros(totals.value(name));
+    parts << "total " + lmc_formatMicros(m_total);
+    return parts.join(" · ");
+}
+
+bool BuildTrace::write(const QString &path) const
+{
+    QJsonArray events;
+    auto trackName = [&events](int track, const QString &name) {
+        QJsonObject meta;
+        meta.insert("name", "thread_name");
+        meta.insert("ph", "M");
+        meta.insert("pid", 1);
+        meta.insert("tid", track);
+        meta.insert("args", QJsonObject{{"name", name}});
+        events << meta;
+    };
+    trackName(0, "pipeline");
+    for (int i = 0; i < m_busyTracks.size(); ++i)
+        trackName(i + 1, QString("job %1").arg(i + 1));
+
+    for (const Span &s : m_spans) {
+        if (s.duration < 0)
+            continue;
+        QJsonObject e;
+        e.insert("name", s.name);
+        e.insert("cat", s.track == 0 ? "phase" : "job");
+        e.insert("ph", "X");
+        e.insert("ts", double(s.start));
+        e.insert("dur", double(s.duration));
+        e.insert("pid", 1);
+        e.insert("tid", s.track);
+        if (s.track != 0)
+            e.insert("args", QJsonObject{{"ok", s.ok}});
+        events << e;
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", events);
+    root.insert("displayTimeUnit", "ms");
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return f.commit();
+}
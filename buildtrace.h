@@ -0,0 +1,46 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// where a build's wall time went. pipeline phases run one after another on
+// track 0, every spawned process lands on the lowest free "job" track, so
+// the parallel compiles show up side by side when build/trace.json is
+// opened in chrome://tracing or Perfetto.
+class BuildTrace
+{
+public:
+    void begin();
+    // closes the running phase (if any) and opens the next one
+    void phase(const QString &name);
+    void end();
+
+    // index is JobRunner's, only unique within one start()
+    void jobStarted(int index, const QString &label);
+    void jobFinished(int index, bool ok);
+
+    // "scan 3 ms · compile 1.84 s · … · total 1.9 s"
+    QString summary() const;
+    bool write(const QString &path) const;
+
+private:
+    struct Span
+    {
+        QString name;
+        int track = 0; // 0 = pipeline, 1.. = job slots
+        qint64 start = 0; // µs since begin()
+        qint64 duration = -1;
+        bool ok = true;
+    };
+
+    qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
+    QElapsedTimer m_clock;
+    QVector<Span> m_spans;
+    int m_phase = -1;              // open phase span
+    QHash<int, int> m_openJobs;    // JobRunner index -> span
+    QVector<bool> m_busyTracks;    // job tracks, false = free
+    qint64 m_total = 0;
+};
@@ -0,0 +1,100 @@
+// (c) 2025 Stardust Softworks
+#include "buildwatcher.h"
+#include <QDateTime>
+#include <QFileInfo>
+
+// long enough to swallow "save all" and format-on-save, short enough not to notice
+static const int kWatchDebounceMs = 250;
+
+static QPair<qint64, qint64> lmc_fileStamp(const QString &path)
+{
+    const QFileInfo fi(path);
+    if (!fi.exists())
+        return {-1, -1};
+    return {fi.lastModified().toMSecsSinceEpoch(), fi.size()};
+}
+
+BuildWatcher::BuildWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(kWatchDebounceMs);
+    connect(&m_debounce, &QTimer::timeout, this, &BuildWatcher::onQuiet);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &BuildWatcher::check);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this,
+            &BuildWatcher::onDirectoryChanged);
+}
+
+void BuildWatcher::setPaths(const QStringList &files)
+{
+    QHash<QString, QPair<qint64, qint64>> next;
+    QHash<QString, QStringList> byDir;
+    for (const QString &f : files) {
+        const QString path = QFileInfo(f).absoluteFilePath();
+        if (next.contains(path))
+            continue;
+        // a file already watched keeps its old stamp, so a save that raced the rebuild still counts
+        next.insert(path, m_files.value(path, lmc_fileStamp(path)));
+        byDir[QFileInfo(path).absolutePath()] << path;
+    }
+
+    if (!m_watcher.files().isEmpty())
+        m_watcher.removePaths(m_watcher.files());
+    if (!m_watcher.directories().isEmpty())
+        m_watcher.removePaths(m_watcher.directories());
+    m_files.swap(next);
+    m_byDir.swap(byDir);
+
+    QStringList existing;
+    for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it)
+        if (it.value().first >= 0)
+            existing << it.key();
+    if (!existing.isEmpty())
+        m_watcher.addPaths(existing);
+    // editors that save by renaming a temp file over the original drop the file watch,
+    // the folder watch is how the new file gets noticed
+    if (!m_byDir.isEmpty())
+        m_watcher.addPaths(m_byDir.keys());
+
+    for (const QString &path : std::as_const(existing))
+        check(path);
+}
+
+void BuildWatcher::stop()
+{
+    m_debounce.stop();
+    m_pending.clear();
+    setPaths({});
+}
+
+void BuildWatcher::check(const QString &path)
+{
+    auto it = m_files.find(path);
+    if (it == m_files.end())
+        return;
+    const QPair<qint64, qint64> now = lmc_fileStamp(path);
+    if (now == it.value())
+        return;
+    it.value() = now;
+    if (now.first >= 0 && !m_watcher.files().contains(path))
+        m_watcher.addPath(path);
+    m_pending.insert(path);
+    m_debounce.start();
+}
+
+void BuildWatcher::onDirectoryChanged(const QString &dir)
+{
+    const QStringList files = m_byDir.value(dir);
+    for (const QString &path : files)
+        check(path);
+}
+
+void BuildWatcher::onQuiet()
+{
+    if (m_pending.isEmpty())
+        return;
+    QStringList files(m_pending.cbegin(), m_pending.cend());
+    files.sort();
+    m_pending.clear();
+    emit changed(files);
+}
@@ -0,0 +1,39 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+// watch mode: notices saves to the project's sources and headers and reports them
+// once things have been quiet for a moment, so a burst of saves (or an editor's
+// write-temp-then-rename dance) turns into one rebuild. files are compared by
+// mtime and size, anything else happening in their folders is ignored.
+class BuildWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BuildWatcher(QObject *parent = nullptr);
+
+    // replaces what is watched, keeps already pending changes
+    void setPaths(const QStringList &files);
+    void stop();
+    bool isActive() const { return !m_files.isEmpty(); }
+
+signals:
+    // the files that changed since the last emit, after the debounce window
+    void changed(const QStringList &files);
+
+private:
+    void check(const QString &path);
+    void onDirectoryChanged(const QString &dir);
+    void onQuiet();
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+    QHash<QString, QPair<qint64, qint64>> m_files; // path -> mtime, size (-1 when missing)
+    QHash<QString, QStringList> m_byDir;
+    QSet<QString> m_pending;
+};
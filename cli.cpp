@@ -0,0 +1,180 @@
+// (c) 2025 Stardust Softworks
+#include "cli.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+#include "buildengine.h"
+#include "logsink.h"
+#include "pgo.h"
+#include "runbench.h"
+
+int lmc_runCli(const QStringList &arguments, const QElapsedTimer &sinceLaunch)
+{
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Build without opening a window. Options add to, or "
+                                     "override, what the project file says.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"build", "Build headless (required for every other option here)."},
+        {"clean", "Remove the target and intermediates before building."},
+        {{"o", "output"}, "Target executable.", "path"},
+        {"compiler", "Compiler to use (default: clang++).", "path"},
+        {"std", "Language standard, e.g. c++20.", "std"},
+        {"profile", "Build profile (Debug, Release, … as set up in the app).", "name"},
+        {"cxxflags", "Compiler flags, may be repeated.", "flags"},
+        {"include", "Include directory, may be repeated.", "dir"},
+        {"define", "Preprocessor define, may be repeated.", "name[=value]"},
+        {"ldflags", "Linker flags, may be repeated.", "flags"},
+        {"lib", "Library to link, e.g. -lm, may be repeated.", "lib"},
+        {{"j", "jobs"}, "Parallel compile jobs (default: one per hardware thread).", "n"},
+        {"pch", "Precompile the headers most sources share."},
+        {"unity", "Compile sources in unity batches."},
+        {"unity-batch", "Sources per unity batch, 0 picks automatically.", "n"},
+        {"time-trace", "Compile with -ftime-trace and print where the time went."},
+        {"opt-remarks", "Save optimization remarks, list missed vectorization, inlining and "
+                        "GVN."},
+        {"linker", "auto (fastest found), lld, mold or default.", "name"},
+        {"split-dwarf", "Debug builds: keep debug info in .dwo files (ELF only)."},
+        {"gdb-index", "Debug builds: add a .gdb_index, needs lld or mold."},
+        {"compress-debug", "Debug builds: compress debug sections (-gz)."},
+        {"thinlto", "Release build with ThinLTO and a persistent LTO cache."},
+        {"pgo", "Instrumented build, training runs, merge, then the optimized build."},
+        {"pgo-run", "Arguments for one PGO training run, may be repeated.", "args"},
+        {"bench", "After a good build, time n runs of the target and compare with the last "
+                  "benchmark of the same profile.", "n"},
+        {"bench-warmup", "Untimed runs before --bench (default: 2).", "n"},
+        {"bench-args", "Arguments for every --bench run.", "args"},
+    });
+    parser.addPositionalArgument("inputs", "A .lmcproj project file and/or source files.",
+                                 "[project.lmcproj] [sources...]");
+    parser.process(arguments);
+
+    LmcBuildConfig config;
+    config.jobs = QThread::idealThreadCount();
+    QStringList sources;
+    for (const QString &input : parser.positionalArguments()) {
+        if (!input.endsWith(".lmcproj", Qt::CaseInsensitive)) {
+            sources << input;
+            continue;
+        }
+        QString error;
+        if (!config.load(input, &error)) {
+            err << "❌ Could not read " << input << ": " << error << "\n";
+            return 1;
+        }
+    }
+    config.files << sources;
+
+    if (parser.isSet("output"))
+        config.output = parser.value("output");
+    if (parser.isSet("compiler"))
+        config.compiler = parser.value("compiler");
+    if (parser.isSet("std"))
+        config.standard = parser.value("std");
+    if (parser.isSet("profile"))
+        config.profile = parser.value("profile");
+    config.cxxflags << parser.values("cxxflags");
+    config.includeDirs << parser.values("include");
+    config.defines << parser.values("define");
+    config.ldflags << parser.values("ldflags");
+    config.libs << parser.values("lib");
+    if (parser.isSet("jobs"))
+        config.jobs = qMax(1, parser.value("jobs").toInt());
+    if (parser.isSet("pch"))
+        config.pch = true;
+    if (parser.isSet("unity"))
+        config.unity = true;
+    if (parser.isSet("unity-batch"))
+        config.unityBatch = parser.value("unity-batch").toInt();
+    if (parser.isSet("time-trace"))
+        config.timeTrace = true;
+    if (parser.isSet("opt-remarks"))
+        config.optRemarks = true;
+    if (parser.isSet("linker"))
+        config.linker = parser.value("linker");
+    if (parser.isSet("split-dwarf"))
+        config.splitDwarf = true;
+    if (parser.isSet("gdb-index"))
+        config.gdbIndex = true;
+    if (parser.isSet("compress-debug"))
+        config.compressDebug = true;
+    if (parser.isSet("thinlto"))
+        config.thinLto = true;
+    config.pgoRuns << parser.values("pgo-run");
+
+    BuildEngine engine;
+    QTextStream out(stdout);
+    QObject::connect(engine.logSink(), &LogSink::flushed, [&out](const QString &text) {
+        out << text;
+        out.flush();
+    });
+
+    // the number scripted builds care about: how long until real work starts
+    bool firstJob = true;
+    QObject::connect(&engine, &BuildEngine::jobStarted, [&](const QString &label) {
+        if (!firstJob)
+            return;
+        firstJob = false;
+        err << "First process (" << label << ") started " << sinceLaunch.elapsed()
+            << " ms after startup\n";
+        err.flush();
+    });
+
+    if (parser.isSet("clean")) {
+        engine.clean(config);
+        engine.logSink()->flush();
+    }
+
+    // the engine finishes twice in a PGO run, only the workflow's end counts
+    if (parser.isSet("pgo")) {
+        PgoWorkflow pgo(&engine);
+        QObject::connect(&pgo, &PgoWorkflow::finished, qApp, &QCoreApplication::quit);
+        if (!pgo.start(config))
+            return pgo.exitCode();
+        QCoreApplication::exec();
+        return pgo.exitCode();
+    }
+
+    QObject::connect(&engine, &BuildEngine::finished, qApp, &QCoreApplication::quit);
+    if (!engine.start(config))
+        return engine.exitCode();
+    if (engine.isRunning())
+        QCoreApplication::exec();
+    if (engine.exitCode() != 0 || !parser.isSet("bench"))
+        return engine.exitCode();
+
+    // the build went fine, time the program it made
+    const QString target = BuildEngine::targetPathWithExt(config.output.trimmed());
+    LmcRunRecord record;
+    record.when = QDateTime::currentDateTimeUtc();
+    record.profile = config.profile;
+    record.flags = engine.buildFlags();
+    record.binary = lmc_binaryStamp(target);
+    record.args = lmc_splitArgs(parser.value("bench-args"));
+    const int runs = qMax(1, parser.value("bench").toInt());
+    const int warmup = parser.isSet("bench-warmup") ? qMax(0, parser.value("bench-warmup").toInt())
+                                                    : 2;
+
+    RunBenchmark bench;
+    QObject::connect(&bench, &RunBenchmark::finished, qApp, &QCoreApplication::quit);
+    out << "Benchmark: " << runs << " run(s) of " << target << " after " << warmup
+        << " warmup\n";
+    out.flush();
+    if (!bench.start(target, record.args, warmup, runs))
+        return 1;
+    QCoreApplication::exec();
+    if (!bench.error().isEmpty()) {
+        err << "❌ Benchmark failed, " << bench.error() << "\n";
+        return 1;
+    }
+    record.stats = bench.stats();
+    out << lmc_formatRunStats(record.stats)
+        << lmc_fileRun(lmc_runHistoryPath(BuildEngine::buildDirForTarget(target)), record);
+    return 0;
+}
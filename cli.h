@@ -0,0 +1,9 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QStringList>
+
+class QElapsedTimer;
+
+// `LazyMansClang --build ...`: runs the build on a QCoreApplication with no widgets,
+// prints the log to stdout and returns what the failing compiler/linker returned
+int lmc_runCli(const QStringList &arguments, const QElapsedTimer &sinceLaunch);
@@ -0,0 +1,351 @@
+// (c) 2025 Stardust Softworks
+#include "compilecache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+#include <algorithm>
+
+// manifests keep only the most recent header sets per key
+static const int kMaxManifestEntries = 16;
+
+static QByteArray lmc_statKey(const QFileInfo &fi)
+{
+    return QByteArray::number(fi.lastModified().toMSecsSinceEpoch()) + ':'
+           + QByteArray::number(fi.size());
+}
+
+static void lmc_touch(const QString &path)
+{
+    QFile f(path);
+    if (f.open(QIODevice::ReadWrite))
+        f.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+}
+
+CompileCache::CompileCache()
+{
+    m_root = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/objcache";
+}
+
+static QString lmc_resolveCompiler(const QString &compiler)
+{
+    if (!QFileInfo(compiler).isAbsolute()) {
+        const QString found = QStandardPaths::findExecutable(compiler);
+        if (!found.isEmpty())
+            return found;
+    }
+    return compiler;
+}
+
+QByteArray CompileCache::compilerId(const QString &compiler) const
+{
+    const QString resolved = lmc_resolveCompiler(compiler);
+    auto it = m_compilerIds.constFind(resolved);
+    if (it != m_compilerIds.constEnd() && it.value().first == lmc_statKey(QFileInfo(resolved)))
+        return it.value().second;
+    return {};
+}
+
+void CompileCache::setCompilerVersion(const QString &compiler, const QByteArray &version)
+{
+    const QString resolved = lmc_resolveCompiler(compiler);
+    const QFileInfo fi(resolved);
+    const QByteArray stat = lmc_statKey(fi);
+
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(fi.canonicalFilePath().toUtf8());
+    h.addData(stat);
+    h.addData(version);
+    m_compilerIds.insert(resolved, {stat, h.result().toHex()});
+}
+
+QByteArray CompileCache::hashFile(const QString &path)
+{
+    const QFileInfo fi(path);
+    if (!fi.exists())
+        return {};
+    const QByteArray stat = lmc_statKey(fi);
+
+    auto it = m_fileHashes.constFind(path);
+    if (it != m_fileHashes.constEnd() && it.value().first == stat)
+        return it.value().second;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return {};
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(&f);
+    const QByteArray hash = h.result().toHex();
+    m_fileHashes.insert(path, {stat, hash});
+    return hash;
+}
+
+QByteArray CompileCache::keyFor(const QByteArray &compilerId,
+                                const QStringList &flags,
+                                const QString &src)
+{
+    const QByteArray srcHash = hashFile(src);
+    if (srcHash.isEmpty())
+        return {};
+
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(compilerId);
+
+    // -Irelative only means something next to the cwd, so key on the absolute dir
+    bool debugInfo = false;
+    for (const QString &f : flags) {
+        QString a = f;
+        if (a.startsWith("-I") && a.size() > 2)
+            a = "-I" + QFileInfo(a.mid(2)).absoluteFilePath();
+        if (a.startsWith("-g") && a != "-g0")
+            debugInfo = true;
+        h.addData(QByteArray(1, '\0'));
+        h.addData(a.toUtf8());
+    }
+    h.addData(QByteArray(1, '\0'));
+    h.addData(srcHash);
+
+    // debug info embeds the source path, so those objects can't move between checkouts
+    if (debugInfo)
+        h.addData(QFileInfo(src).absoluteFilePath().toUtf8());
+    return h.result().toHex();
+}
+
+QByteArray CompileCache::digestOf(const QStringList &paths)
+{
+    if (paths.isEmpty())
+        return {};
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    for (const QString &p : paths) {
+        const QByteArray hash = hashFile(p);
+        if (hash.isEmpty())
+            return {};
+        h.addData(hash);
+    }
+    return h.result().toHex();
+}
+
+QString CompileCache::manifestPath(const QByteArray &key) const
+{
+    return m_root + "/manifests/" + QString::fromLatin1(key.left(2)) + "/"
+           + QString::fromLatin1(key) + ".json";
+}
+
+QString CompileCache::objectPath(const QByteArray &objKey) const
+{
+    return m_root + "/objects/" + QString::fromLatin1(objKey.left(2)) + "/"
+           + QString::fromLatin1(objKey) + ".o";
+}
+
+bool CompileCache::fetch(const QByteArray &key, const LmcTuFiles &tu)
+{
+    if (!m_enabled || key.isEmpty())
+        return false;
+
+    QFile mf(manifestPath(key));
+    if (mf.open(QIODevice::ReadOnly)) {
+        const QJsonArray entries = QJsonDocument::fromJson(mf.readAll())
+                                       .object()
+                                       .value("entries")
+                                       .toArray();
+        for (const QJsonValue &v : entries) {
+            const QJsonObject e = v.toObject();
+            const QJsonArray deps = e.value("deps").toArray();
+
+            QStringList depPaths;
+            bool match = true;
+            for (const QJsonValue &dv : deps) {
+                const QJsonObject d = dv.toObject();
+                const QString path = d.value("path").toString();
+                if (hashFile(path) != d.value("hash").toString().toLatin1()) {
+                    match = false;
+                    break;
+                }
+                depPaths << path;
+            }
+            if (!match)
+                continue;
+
+            const QString cached = objectPath(e.value("object").toString().toLatin1());
+            if (!QFile::exists(cached))
+                continue;
+
+            QFile::remove(tu.obj);
+            if (!QFile::copy(cached, tu.obj))
+                continue;
+            // the restored object must look newer than its headers to the incremental check
+            lmc_touch(tu.obj);
+            lmc_touch(cached);
+            lmc_writeDepFile(tu.dep, tu.obj, depPaths);
+            ++m_hits;
+            return true;
+        }
+    }
+    ++m_misses;
+    return false;
+}
+
+void CompileCache::store(const QByteArray &key, const LmcTuFiles &tu)
+{
+    if (!m_enabled || key.isEmpty())
+        return;
+
+    const QStringList depPaths = lmc_readDepFile(tu.dep);
+    if (depPaths.isEmpty())
+        return;
+
+    QJsonArray deps;
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(key);
+    for (const QString &path : depPaths) {
+        const QByteArray hash = hashFile(path);
+        if (hash.isEmpty())
+            return; // header vanished mid-build, don't cache a guess
+        h.addData(hash);
+        QJsonObject d;
+        d.insert("path", path);
+        d.insert("hash", QString::fromLatin1(hash));
+        deps.append(d);
+    }
+    const QByteArray objKey = h.result().toHex();
+
+    const QString cached = objectPath(objKey);
+    if (!QFile::exists(cached)) {
+        QDir().mkpath(QFileInfo(cached).absolutePath());
+        const QString tmp = cached + ".tmp";
+        QFile::remove(tmp);
+        if (!QFile::copy(tu.obj, tmp) || !QFile::rename(tmp, cached)) {
+            QFile::remove(tmp);
+            return;
+        }
+        ++m_stored;
+    }
+    lmc_touch(cached);
+
+    // newest entry first, older header sets fall off the end
+    const QString mpath = manifestPath(key);
+    QJsonArray entries;
+    {
+        QFile mf(mpath);
+        if (mf.open(QIODevice::ReadOnly))
+            entries = QJsonDocument::fromJson(mf.readAll()).object().value("entries").toArray();
+    }
+    for (int i = entries.size() - 1; i >= 0; --i)
+        if (entries.at(i).toObject().value("object").toString().toLatin1() == objKey)
+            entries.removeAt(i);
+
+    QJsonObject entry;
+    entry.insert("object", QString::fromLatin1(objKey));
+    entry.insert("deps", deps);
+    entries.prepend(entry);
+    while (entries.size() > kMaxManifestEntries)
+        entries.removeLast();
+
+    QDir().mkpath(QFileInfo(mpath).absolutePath());
+    QSaveFile out(mpath);
+    if (out.open(QIODevice::WriteOnly)) {
+        QJsonObject root;
+        root.insert("entries", entries);
+        out.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        out.commit();
+    }
+}
+
+void CompileCache::beginBuild()
+{
+    m_hits = 0;
+    m_misses = 0;
+    m_stored = 0;
+}
+
+QString CompileCache::endBuild()
+{
+    if (!m_enabled)
+        return {};
+
+    QDir().mkpath(m_root);
+    const QString statsPath = m_root + "/stats.json";
+    QJsonObject stats;
+    {
+        QFile f(statsPath);
+        if (f.open(QIODevice::ReadOnly))
+            stats = QJsonDocument::fromJson(f.readAll()).object();
+    }
+    const qint64 totalHits = stats.value("hits").toVariant().toLongLong() + m_hits;
+    const qint64 totalMisses = stats.value("misses").toVariant().toLongLong() + m_misses;
+
+    // only walk the store when it can have grown
+    qint64 bytes = stats.value("bytes").toVariant().toLongLong();
+    if (m_stored > 0 || bytes <= 0)
+        bytes = trim();
+
+    stats.insert("hits", totalHits);
+    stats.insert("misses", totalMisses);
+    stats.insert("bytes", bytes);
+    QSaveFile out(statsPath);
+    if (out.open(QIODevice::WriteOnly)) {
+        out.write(QJsonDocument(stats).toJson());
+        out.commit();
+    }
+
+    auto pct = [](qint64 h, qint64 m) {
+        return (h + m) > 0 ? (100.0 * h) / (h + m) : 0.0;
+    };
+    return QString("Cache: %1 hit(s), %2 miss(es) (%3%) this build, %4% overall, %5 / %6 MB\n")
+        .arg(m_hits)
+        .arg(m_misses)
+        .arg(pct(m_hits, m_misses), 0, 'f', 0)
+        .arg(pct(totalHits, totalMisses), 0, 'f', 0)
+        .arg(bytes / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(m_maxBytes / (1024 * 1024));
+}
+
+// evict least recently used objects until the store fits, returns bytes left
+qint64 CompileCache::trim()
+{
+    struct Entry
+    {
+        QString path;
+        qint64 size;
+        qint64 mtime;
+    };
+    QVector<Entry> objs;
+    qint64 total = 0;
+
+    QDirIterator it(m_root + "/objects", {"*.o"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        objs.push_back({fi.absoluteFilePath(), fi.size(), fi.lastModified().toMSecsSinceEpoch()});
+        total += fi.size();
+    }
+    if (total <= m_maxBytes)
+        return total;
+
+    // stale manifest entries pointing at evicted objects are skipped on fetch
+    std::sort(objs.begin(), objs.end(), [](const Entry &a, const Entry &b) {
+        return a.mtime < b.mtime;
+    });
+    const qint64 target = m_maxBytes * 9 / 10; // some headroom so we don't trim every build
+    for (const Entry &e : objs) {
+        if (total <= target)
+            break;
+        if (QFile::remove(e.path))
+            total -= e.size;
+    }
+    return total;
+}
+
+void CompileCache::clear()
+{
+    QDir(m_root).removeRecursively();
+    m_fileHashes.clear();
+}
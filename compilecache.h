@@ -0,0 +1,65 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QStringList>
+#include "incremental.h"
+
+// content-addressed object cache shared by every target (think ccache).
+//
+// manifests/<key>.json  key = compiler identity + normalized flags + source hash,
+//                       lists the header sets seen for that key and their results
+// objects/<obj>.o       obj = key + hashes of every header the TU pulled in
+//
+// eviction is LRU by file mtime, which a hit refreshes.
+class CompileCache
+{
+public:
+    CompileCache();
+
+    void setEnabled(bool on) { m_enabled = on; }
+    bool isEnabled() const { return m_enabled; }
+    void setMaxBytes(qint64 bytes) { m_maxBytes = bytes; }
+    qint64 maxBytes() const { return m_maxBytes; }
+    QString root() const { return m_root; }
+
+    // binary path + `--version`, memoized per path/mtime/size. empty until setCompilerVersion()
+    // saw this binary: the caller runs `compiler --version` off the GUI thread
+    QByteArray compilerId(const QString &compiler) const;
+    void setCompilerVersion(const QString &compiler, const QByteArray &version);
+
+    // manifest key for one TU, empty when the source can't be read
+    QByteArray keyFor(const QByteArray &compilerId, const QStringList &flags, const QString &src);
+    // one hash over the contents of several files, empty when any of them is missing
+    QByteArray digestOf(const QStringList &paths);
+
+    // restore tu.obj and tu.dep from the cache, counts a hit or a miss
+    bool fetch(const QByteArray &key, const LmcTuFiles &tu);
+    // publish a freshly compiled object (reads headers from tu.dep)
+    void store(const QByteArray &key, const LmcTuFiles &tu);
+
+    void beginBuild();
+    // folds this build's counters into the persistent stats and evicts down to the cap
+    QString endBuild();
+    void clear();
+
+    int hits() const { return m_hits; }
+    int misses() const { return m_misses; }
+
+private:
+    QByteArray hashFile(const QString &path);
+    QString manifestPath(const QByteArray &key) const;
+    QString objectPath(const QByteArray &objKey) const;
+    qint64 trim();
+
+    QString m_root;
+    bool m_enabled = true;
+    qint64 m_maxBytes = 2048LL * 1024 * 1024;
+    int m_hits = 0;
+    int m_misses = 0;
+    int m_stored = 0;
+
+    QHash<QString, QPair<QByteArray, QByteArray>> m_compilerIds; // path -> (stat, id)
+    QHash<QString, QPair<QByteArray, QByteArray>> m_fileHashes;  // path -> (stat, hash)
+};
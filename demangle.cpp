@@ -0,0 +1,26 @@
+// (c) 2025 Stardust Softworks
+#include "demangle.h"
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <cstdlib>
+#define LMC_HAVE_CXXABI 1
+#endif
+
+QString lmc_demangle(const QString &name)
+{
+#ifdef LMC_HAVE_CXXABI
+    // plain names go through untouched, "i" would come back as "int"
+    if (!name.startsWith("_Z"))
+        return name;
+    const QByteArray raw = name.toUtf8();
+    int status = 0;
+    char *out = abi::__cxa_demangle(raw.constData(), nullptr, nullptr, &status);
+    if (status == 0 && out) {
+        const QString pretty = QString::fromUtf8(out);
+        std::free(out);
+        return pretty;
+    }
+    std::free(out);
+#endif
+    return name;
+}
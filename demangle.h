@@ -0,0 +1,6 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QString>
+
+// _Z... -> readable C++ (where the C++ runtime can do it), anything else comes back as is
+QString lmc_demangle(const QString &name);
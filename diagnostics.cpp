@@ -0,0 +1,540 @@
+// (c) 2025 Stardust Softworks
+#include "diagnostics.h"
+#include <QFile>
+#include <QFileInfo>
+
+// clang/Frontend/SerializedDiagnostics.h
+enum : quint64 {
+    kBlockInfoBlock = 0,
+    kMetaBlock = 8,
+    kDiagBlock = 9,
+};
+enum : quint64 {
+    kRecordDiag = 2,
+    kRecordDiagFlag = 4,
+    kRecordCategory = 5,
+    kRecordFilename = 6,
+};
+
+namespace {
+
+// just enough of LLVM's bitstream format (abbreviations, blockinfo, blobs) for .dia files
+class LmcBitReader
+{
+public:
+    explicit LmcBitReader(const QByteArray &data)
+        : m_data(data)
+        , m_bits(qint64(data.size()) * 8)
+    {}
+
+    bool ok() const { return !m_failed; }
+    void fail() { m_failed = true; }
+    bool atEnd() const { return m_failed || m_pos >= m_bits; }
+
+    quint64 fixed(int width)
+    {
+        if (width > 64 || m_pos + width > m_bits) {
+            m_failed = true;
+            return 0;
+        }
+        quint64 v = 0;
+        for (int i = 0; i < width; ++i, ++m_pos)
+            if (quint8(m_data.at(int(m_pos >> 3))) & (1u << (m_pos & 7)))
+                v |= quint64(1) << i;
+        return v;
+    }
+
+    quint64 vbr(int width)
+    {
+        if (width < 2) {
+            m_failed = true;
+            return 0;
+        }
+        const quint64 more = quint64(1) << (width - 1);
+        quint64 v = 0;
+        for (int shift = 0; shift < 64 && ok(); shift += width - 1) {
+            const quint64 piece = fixed(width);
+            v |= (piece & (more - 1)) << shift;
+            if (!(piece & more))
+                return v;
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    quint64 char6()
+    {
+        static const char table[] = "abcdefghijklmnopqrstuvwxyz"
+                                    "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._";
+        return quint64(quint8(table[fixed(6)]));
+    }
+
+    void align32() { m_pos = (m_pos + 31) & ~qint64(31); }
+
+    void skip(qint64 bits)
+    {
+        m_pos += bits;
+        if (m_pos > m_bits)
+            m_failed = true;
+    }
+
+    QByteArray bytes(qint64 n)
+    {
+        align32();
+        if (m_pos + n * 8 > m_bits) {
+            m_failed = true;
+            return {};
+        }
+        const QByteArray b = m_data.mid(int(m_pos >> 3), int(n));
+        m_pos += n * 8;
+        align32();
+        return b;
+    }
+
+private:
+    const QByteArray &m_data;
+    qint64 m_bits;
+    qint64 m_pos = 0;
+    bool m_failed = false;
+};
+
+struct LmcAbbrevOp
+{
+    enum Kind { Literal, Fixed, Vbr, Array, Char6, Blob };
+    Kind kind = Literal;
+    quint64 value = 0;
+};
+using LmcAbbrev = QVector<LmcAbbrevOp>;
+
+struct LmcRecord
+{
+    quint64 code = 0;
+    QVector<quint64> ops;
+    QByteArray blob;
+
+    // the trailing string of a record, blob or (unabbreviated) one op per char
+    QByteArray text(int first) const
+    {
+        if (!blob.isNull())
+            return blob;
+        QByteArray s;
+        for (int i = first; i < ops.size(); ++i)
+            s += char(ops.at(i));
+        return s;
+    }
+};
+
+class LmcDiaParser
+{
+public:
+    LmcDiaParser(const QByteArray &data, QVector<LmcDiagnostic> *out)
+        : m_in(data)
+        , m_out(out)
+    {}
+
+    bool parse()
+    {
+        if (m_in.fixed(8) != 'D' || m_in.fixed(8) != 'I' || m_in.fixed(8) != 'A'
+            || m_in.fixed(8) != 'G')
+            return false;
+        // top level: abbreviation width 2, nothing but blocks
+        while (!m_in.atEnd()) {
+            if (m_in.fixed(2) != 1 || !enterBlock(-1))
+                return false;
+        }
+        return m_in.ok();
+    }
+
+private:
+    bool enterBlock(int parent)
+    {
+        const quint64 id = m_in.vbr(8);
+        const int width = int(m_in.vbr(4));
+        m_in.align32();
+        const quint64 words = m_in.fixed(32);
+        if (!m_in.ok())
+            return false;
+        if (id != kBlockInfoBlock && id != kMetaBlock && id != kDiagBlock) {
+            m_in.skip(qint64(words) * 32);
+            return m_in.ok();
+        }
+        return readBlock(id, width, parent);
+    }
+
+    bool readBlock(quint64 blockId, int width, int parent)
+    {
+        QVector<LmcAbbrev> abbrevs = m_blockInfo.value(blockId);
+        quint64 infoTarget = ~quint64(0); // BLOCKINFO: the block SETBID pointed at
+        int current = parent;             // diagnostic defined by this block
+
+        while (!m_in.atEnd()) {
+            const quint64 id = m_in.fixed(width);
+            if (id == 0) { // END_BLOCK
+                m_in.align32();
+                return m_in.ok();
+            }
+            if (id == 1) { // ENTER_SUBBLOCK, notes nest inside the diagnostic they explain
+                if (!enterBlock(parent >= 0 ? parent : current))
+                    return false;
+                continue;
+            }
+            if (id == 2) { // DEFINE_ABBREV
+                const LmcAbbrev a = readAbbrev();
+                if (blockId == kBlockInfoBlock)
+                    m_blockInfo[infoTarget] << a;
+                else
+                    abbrevs << a;
+                continue;
+            }
+
+            LmcRecord rec;
+            if (id == 3) { // UNABBREV_RECORD
+                rec.code = m_in.vbr(6);
+                const quint64 n = m_in.vbr(6);
+                for (quint64 i = 0; i < n && m_in.ok(); ++i)
+                    rec.ops << m_in.vbr(6);
+            } else if (id - 4 < quint64(abbrevs.size())) {
+                readAbbreviated(abbrevs.at(int(id - 4)), &rec);
+            } else {
+                return false;
+            }
+            if (!m_in.ok())
+                return false;
+
+            if (blockId == kBlockInfoBlock && rec.code == 1 && !rec.ops.isEmpty()) // SETBID
+                infoTarget = rec.ops.first();
+            else if (blockId == kDiagBlock)
+                handleRecord(rec, parent, &current);
+        }
+        return false;
+    }
+
+    LmcAbbrev readAbbrev()
+    {
+        LmcAbbrev a;
+        const quint64 n = m_in.vbr(5);
+        for (quint64 i = 0; i < n && m_in.ok(); ++i) {
+            LmcAbbrevOp op;
+            if (m_in.fixed(1)) {
+                op.kind = LmcAbbrevOp::Literal;
+                op.value = m_in.vbr(8);
+            } else {
+                switch (m_in.fixed(3)) {
+                case 1: op.kind = LmcAbbrevOp::Fixed; op.value = m_in.vbr(5); break;
+                case 2: op.kind = LmcAbbrevOp::Vbr; op.value = m_in.vbr(5); break;
+                case 3: op.kind = LmcAbbrevOp::Array; break;
+                case 4: op.kind = LmcAbbrevOp::Char6; break;
+                case 5: op.kind = LmcAbbrevOp::Blob; break;
+                default: m_in.fail(); break;
+                }
+            }
+            a << op;
+        }
+        return a;
+    }
+
+    quint64 readScalar(const LmcAbbrevOp &op)
+    {
+        switch (op.kind) {
+        case LmcAbbrevOp::Literal: return op.value;
+        case LmcAbbrevOp::Fixed: return op.value ? m_in.fixed(int(op.value)) : 0;
+        case LmcAbbrevOp::Vbr: return op.value ? m_in.vbr(int(op.value)) : 0;
+        case LmcAbbrevOp::Char6: return m_in.char6();
+        default: m_in.fail(); return 0; // arrays of arrays/blobs don't exist
+        }
+    }
+
+    void readAbbreviated(const LmcAbbrev &a, LmcRecord *rec)
+    {
+        QVector<quint64> vals;
+        for (int i = 0; i < a.size() && m_in.ok(); ++i) {
+            const LmcAbbrevOp &op = a.at(i);
+            if (op.kind == LmcAbbrevOp::Array) {
+                // the element encoding is the op after it, and the last one
+                const quint64 n = m_in.vbr(6);
+                if (++i >= a.size()) {
+                    m_in.fail();
+                    return;
+                }
+                for (quint64 k = 0; k < n && m_in.ok(); ++k)
+                    vals << readScalar(a.at(i));
+            } else if (op.kind == LmcAbbrevOp::Blob) {
+                rec->blob = m_in.bytes(qint64(m_in.vbr(6)));
+            } else {
+                vals << readScalar(op);
+            }
+        }
+        if (!vals.isEmpty())
+            rec->code = vals.takeFirst();
+        rec->ops = vals;
+    }
+
+    void handleRecord(const LmcRecord &rec, int parent, int *current)
+    {
+        const QVector<quint64> &o = rec.ops;
+        switch (rec.code) {
+        case kRecordFilename: // [file id, size, mtime, length] name
+            if (o.size() >= 4)
+                m_files.insert(o.at(0), QString::fromUtf8(rec.text(4)));
+            break;
+        case kRecordDiagFlag: // [flag id, length] name
+            if (o.size() >= 2)
+                m_flags.insert(o.at(0), QString::fromUtf8(rec.text(2)));
+            break;
+        case kRecordCategory: // [category id, length] name
+            if (o.size() >= 2)
+                m_categories.insert(o.at(0), QString::fromUtf8(rec.text(2)));
+            break;
+        // [level, file id, line, column, offset, category, flag id, length] text
+        case kRecordDiag: {
+            if (o.size() < 8)
+                break;
+            LmcDiagnostic d;
+            d.severity = o.at(0) <= LmcDiagnostic::Remark ? LmcDiagnostic::Severity(o.at(0))
+                                                          : LmcDiagnostic::Error;
+            d.file = m_files.value(o.at(1));
+            d.line = int(o.at(2));
+            d.column = int(o.at(3));
+            d.category = m_categories.value(o.at(5));
+            const QString flag = m_flags.value(o.at(6));
+            if (!flag.isEmpty())
+                d.flag = flag.startsWith('-') ? flag
+                         : (d.severity == LmcDiagnostic::Remark ? "-R" : "-W") + flag;
+            d.message = QString::fromUtf8(rec.text(8));
+            d.parent = parent;
+            *current = m_out->size();
+            m_out->append(d);
+            break;
+        }
+        default: // version, source ranges, fix-its
+            break;
+        }
+    }
+
+    LmcBitReader m_in;
+    QVector<LmcDiagnostic> *m_out;
+    QHash<quint64, QVector<LmcAbbrev>> m_blockInfo;
+    QHash<quint64, QString> m_files;
+    QHash<quint64, QString> m_flags;
+    QHash<quint64, QString> m_categories;
+};
+
+} // namespace
+
+bool lmc_readDiagnostics(const QString &path, QVector<LmcDiagnostic> *out)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = f.readAll();
+    return LmcDiaParser(data, out).parse();
+}
+
+static int lmc_severityRank(LmcDiagnostic::Severity s)
+{
+    switch (s) {
+    case LmcDiagnostic::Fatal: return 4;
+    case LmcDiagnostic::Error: return 3;
+    case LmcDiagnostic::Warning: return 2;
+    case LmcDiagnostic::Remark: return 1;
+    default: return 0;
+    }
+}
+
+static QString lmc_severityName(LmcDiagnostic::Severity s)
+{
+    switch (s) {
+    case LmcDiagnostic::Fatal: return "fatal";
+    case LmcDiagnostic::Error: return "error";
+    case LmcDiagnostic::Warning: return "warning";
+    case LmcDiagnostic::Remark: return "remark";
+    case LmcDiagnostic::Note: return "note";
+    default: return "ignored";
+    }
+}
+
+static QString lmc_location(const LmcDiagnostic &d, bool fullPath)
+{
+    if (d.file.isEmpty())
+        return QString();
+    QString s = fullPath ? d.file : QFileInfo(d.file).fileName();
+    if (d.line > 0)
+        s += ':' + QString::number(d.line);
+    if (d.column > 0)
+        s += ':' + QString::number(d.column);
+    return s;
+}
+
+DiagnosticsModel::DiagnosticsModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{}
+
+void DiagnosticsModel::clear()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_byKey.clear();
+    m_errors = 0;
+    m_warnings = 0;
+    m_duplicates = 0;
+    m_firstError = -1;
+    endResetModel();
+}
+
+void DiagnosticsModel::add(const QVector<LmcDiagnostic> &diags)
+{
+    QVector<Row> fresh;
+    QVector<int> rowOf(diags.size(), -1); // diag index -> row, for its notes
+    QVector<int> bumped;
+
+    for (int i = 0; i < diags.size(); ++i) {
+        const LmcDiagnostic &d = diags.at(i);
+        if (d.severity == LmcDiagnostic::Ignored)
+            continue;
+
+        if (d.parent >= 0 && d.parent < i) {
+            // a duplicate's notes were kept with the first copy already
+            const int row = rowOf.at(d.parent);
+            if (row >= m_rows.size() + fresh.size() || row < 0)
+                continue;
+            Row &r = row < m_rows.size() ? m_rows[row] : fresh[row - m_rows.size()];
+            if (r.count == 1)
+                r.notes << (lmc_location(d, true) + ": " + d.message);
+            continue;
+        }
+
+        const QString key = QString::number(d.severity) + '|' + d.file + '|'
+                            + QString::number(d.line) + '|' + QString::number(d.column) + '|'
+                            + d.message;
+        auto it = m_byKey.constFind(key);
+        if (it != m_byKey.constEnd()) {
+            const int row = it.value();
+            if (row < m_rows.size()) {
+                ++m_rows[row].count;
+                bumped << row;
+            } else {
+                ++fresh[row - m_rows.size()].count;
+            }
+            rowOf[i] = row;
+            ++m_duplicates;
+            continue;
+        }
+
+        const int row = m_rows.size() + fresh.size();
+        m_byKey.insert(key, row);
+        rowOf[i] = row;
+        Row r;
+        r.diag = d;
+        fresh << r;
+        if (lmc_severityRank(d.severity) >= 3) {
+            ++m_errors;
+            if (m_firstError < 0)
+                m_firstError = row;
+        } else if (d.severity == LmcDiagnostic::Warning) {
+            ++m_warnings;
+        }
+    }
+
+    for (const int row : std::as_const(bumped))
+        emit dataChanged(index(row, CountColumn), index(row, CountColumn));
+    if (fresh.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + fresh.size() - 1);
+    m_rows << fresh;
+    endInsertRows();
+}
+
+int DiagnosticsModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int DiagnosticsModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant DiagnosticsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return {};
+    const Row &r = m_rows.at(index.row());
+    const LmcDiagnostic &d = r.diag;
+
+    if (role == SeverityRole)
+        return lmc_severityRank(d.severity);
+    if (role == SortRole) {
+        switch (index.column()) {
+        case SeverityColumn: return lmc_severityRank(d.severity) * 1000000 - index.row();
+        case CountColumn: return r.count;
+        case LocationColumn: return QString("%1\n%2").arg(d.file).arg(d.line, 9, 10, QChar('0'));
+        default: return data(index, Qt::DisplayRole);
+        }
+    }
+    if (role == Qt::ToolTipRole) {
+        QString tip = lmc_location(d, true) + "\n" + d.message;
+        if (!d.category.isEmpty())
+            tip += " (" + d.category + ")";
+        for (const QString &n : r.notes)
+            tip += "\n  note: " + n;
+        return tip;
+    }
+    if (role != Qt::DisplayRole)
+        return {};
+    switch (index.column()) {
+    case SeverityColumn: return lmc_severityName(d.severity);
+    case LocationColumn: return lmc_location(d, false);
+    case MessageColumn:
+        return r.notes.isEmpty() ? d.message
+                                 : QString("%1 (+%2 notes)").arg(d.message).arg(r.notes.size());
+    case FlagColumn: return d.flag;
+    case CountColumn: return r.count;
+    default: return {};
+    }
+}
+
+QVariant DiagnosticsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return {};
+    switch (section) {
+    case SeverityColumn: return tr("Severity");
+    case LocationColumn: return tr("Location");
+    case MessageColumn: return tr("Message");
+    case FlagColumn: return tr("Flag");
+    case CountColumn: return tr("Count");
+    default: return {};
+    }
+}
+
+DiagnosticsFilter::DiagnosticsFilter(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setSortRole(DiagnosticsModel::SortRole);
+}
+
+void DiagnosticsFilter::setText(const QString &text)
+{
+    m_text = text.trimmed();
+    invalidateFilter();
+}
+
+void DiagnosticsFilter::setMinimumSeverity(LmcDiagnostic::Severity severity)
+{
+    m_minRank = lmc_severityRank(severity);
+    invalidateFilter();
+}
+
+bool DiagnosticsFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QAbstractItemModel *m = sourceModel();
+    const QModelIndex first = m->index(sourceRow, 0, sourceParent);
+    if (first.data(DiagnosticsModel::SeverityRole).toInt() < m_minRank)
+        return false;
+    if (m_text.isEmpty())
+        return true;
+    // the tooltip has the full path, message, category and notes
+    const QModelIndex flag = m->index(sourceRow, DiagnosticsModel::FlagColumn, sourceParent);
+    return first.data(Qt::ToolTipRole).toString().contains(m_text, Qt::CaseInsensitive)
+           || flag.data().toString().contains(m_text, Qt::CaseInsensitive);
+}
@@ -0,0 +1,96 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSortFilterProxyModel>
+#include <QStringList>
+#include <QVector>
+
+// one diagnostic out of clang's --serialize-diagnostics file (<object>.dia)
+struct LmcDiagnostic
+{
+    enum Severity { Ignored, Note, Warning, Error, Fatal, Remark }; // clang's own numbering
+
+    Severity severity = Error;
+    QString file; // empty when clang had no location for it
+    int line = 0;
+    int column = 0;
+    QString message;
+    QString flag;     // "-Wunused-variable", empty for hard errors
+    QString category; // "Semantic Issue" and friends
+    int parent = -1;  // notes: index of the diagnostic they belong to
+};
+
+// the .dia file is LLVM bitstream: every diagnostic in emission order, notes
+// right after their parent. false when the file is missing or not a .dia
+bool lmc_readDiagnostics(const QString &path, QVector<LmcDiagnostic> *out);
+
+// every diagnostic of a build, one row per distinct warning/error. a header that
+// trips the same warning in 300 TUs is one row with a count of 300, its notes
+// are kept once, for the tooltip. rows only ever get appended, so a flood
+// costs one insert per TU.
+class DiagnosticsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        SeverityColumn,
+        LocationColumn,
+        MessageColumn,
+        FlagColumn,
+        CountColumn,
+        ColumnCount
+    };
+    // what the proxy sorts and filters on: severity rank, or arrival order for the rest
+    static const int SortRole = Qt::UserRole;
+    static const int SeverityRole = Qt::UserRole + 1;
+
+    explicit DiagnosticsModel(QObject *parent = nullptr);
+
+    void clear();
+    void add(const QVector<LmcDiagnostic> &diags);
+
+    const LmcDiagnostic &diagnosticAt(int row) const { return m_rows.at(row).diag; }
+    int errors() const { return m_errors; }
+    int warnings() const { return m_warnings; }
+    int duplicates() const { return m_duplicates; }
+    int firstErrorRow() const { return m_firstError; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+private:
+    struct Row
+    {
+        LmcDiagnostic diag;
+        QStringList notes;
+        int count = 1;
+    };
+
+    QVector<Row> m_rows;
+    QHash<QString, int> m_byKey; // severity|file|line|column|message -> row
+    int m_errors = 0;
+    int m_warnings = 0;
+    int m_duplicates = 0;
+    int m_firstError = -1;
+};
+
+// text + minimum severity on top of DiagnosticsModel
+class DiagnosticsFilter : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit DiagnosticsFilter(QObject *parent = nullptr);
+
+    void setText(const QString &text);
+    void setMinimumSeverity(LmcDiagnostic::Severity severity);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString m_text;
+    int m_minRank = 0;
+};
@@ -0,0 +1,115 @@
+// (c) 2025 Stardust Softworks
+#include "diagnosticsview.h"
+#include <QComboBox>
+#include <QDesktopServices>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTableView>
+#include <QUrl>
+#include <QVBoxLayout>
+#include "diagnostics.h"
+
+DiagnosticsView::DiagnosticsView(QWidget *parent)
+    : QWidget(parent)
+    , model(new DiagnosticsModel(this))
+    , filter(new DiagnosticsFilter(this))
+{
+    filter->setSourceModel(model);
+
+    filterEdit = new QLineEdit(this);
+    filterEdit->setPlaceholderText(tr("Filter by text, file or -W flag"));
+    filterEdit->setClearButtonEnabled(true);
+    connect(filterEdit, &QLineEdit::textChanged, filter, &DiagnosticsFilter::setText);
+
+    severityBox = new QComboBox(this);
+    severityBox->addItem(tr("All"), int(LmcDiagnostic::Ignored));
+    severityBox->addItem(tr("Warnings and Errors"), int(LmcDiagnostic::Warning));
+    severityBox->addItem(tr("Errors Only"), int(LmcDiagnostic::Error));
+    connect(severityBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this] {
+        filter->setMinimumSeverity(
+            LmcDiagnostic::Severity(severityBox->currentData().toInt()));
+    });
+
+    firstErrorBtn = new QPushButton(tr("First Error"), this);
+    firstErrorBtn->setEnabled(false);
+    connect(firstErrorBtn, &QPushButton::clicked, this, &DiagnosticsView::showFirstError);
+
+    summaryLabel = new QLabel(this);
+
+    table = new QTableView(this);
+    table->setModel(filter);
+    table->setSortingEnabled(true);
+    table->sortByColumn(DiagnosticsModel::SeverityColumn, Qt::DescendingOrder);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setWordWrap(false);
+    table->verticalHeader()->hide();
+    table->horizontalHeader()->setSectionResizeMode(DiagnosticsModel::MessageColumn,
+                                                    QHeaderView::Stretch);
+    connect(table, &QTableView::doubleClicked, this, &DiagnosticsView::openRow);
+
+    auto *bar = new QHBoxLayout;
+    bar->addWidget(filterEdit, 1);
+    bar->addWidget(severityBox);
+    bar->addWidget(firstErrorBtn);
+    bar->addWidget(summaryLabel);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(bar);
+    layout->addWidget(table);
+
+    connect(model, &QAbstractItemModel::modelReset, this, &DiagnosticsView::updateSummary);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &DiagnosticsView::updateSummary);
+    connect(model, &QAbstractItemModel::dataChanged, this, &DiagnosticsView::updateSummary);
+    updateSummary();
+}
+
+void DiagnosticsView::clear()
+{
+    model->clear();
+}
+
+void DiagnosticsView::add(const QVector<LmcDiagnostic> &diags)
+{
+    model->add(diags);
+}
+
+void DiagnosticsView::updateSummary()
+{
+    QString text = tr("%1 error(s), %2 warning(s)").arg(model->errors()).arg(model->warnings());
+    if (model->duplicates() > 0)
+        text += tr(", %1 duplicate(s) collapsed").arg(model->duplicates());
+    summaryLabel->setText(text);
+    firstErrorBtn->setEnabled(model->firstErrorRow() >= 0);
+}
+
+// the first error clang reported, not the first one in the current sort order
+void DiagnosticsView::showFirstError()
+{
+    const int row = model->firstErrorRow();
+    if (row < 0)
+        return;
+    QModelIndex index = filter->mapFromSource(model->index(row, 0));
+    if (!index.isValid()) {
+        // filtered away, show everything again rather than jump nowhere
+        filterEdit->clear();
+        severityBox->setCurrentIndex(0);
+        index = filter->mapFromSource(model->index(row, 0));
+    }
+    table->selectRow(index.row());
+    table->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    table->setFocus();
+}
+
+// no line numbers through QDesktopServices, the location column has them
+void DiagnosticsView::openRow(const QModelIndex &index)
+{
+    const LmcDiagnostic &diag = model->diagnosticAt(filter->mapToSource(index).row());
+    if (!diag.file.isEmpty() && QFileInfo::exists(diag.file))
+        QDesktopServices::openUrl(QUrl::fromLocalFile(diag.file));
+}
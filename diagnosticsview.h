@@ -0,0 +1,38 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QVector>
+#include <QWidget>
+
+class DiagnosticsFilter;
+class DiagnosticsModel;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTableView;
+struct LmcDiagnostic;
+
+// the build's warnings and errors as a table: sortable, filterable, duplicates
+// collapsed, double-click opens the file. fed by BuildEngine::diagnostics()
+class DiagnosticsView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit DiagnosticsView(QWidget *parent = nullptr);
+
+    void clear();
+    void add(const QVector<LmcDiagnostic> &diags);
+
+private:
+    void updateSummary();
+    void showFirstError();
+    void openRow(const QModelIndex &index);
+
+    DiagnosticsModel *model{};
+    DiagnosticsFilter *filter{};
+    QLineEdit *filterEdit{};
+    QComboBox *severityBox{};
+    QLabel *summaryLabel{};
+    QPushButton *firstErrorBtn{};
+    QTableView *table{};
+};
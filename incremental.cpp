@@ -0,0 +1,204 @@
+// (c) 2025 Stardust Softworks
+#include "incremental.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+static QString lmc_swapSuffix(const QString &obj, const QString &suffix)
+{
+    QString base = obj;
+    if (base.endsWith(".o"))
+        base.chop(2);
+    return base + suffix;
+}
+
+LmcTuFiles lmc_tuFiles(const QString &src, const QString &obj)
+{
+    LmcTuFiles tu;
+    tu.src = src;
+    tu.obj = obj;
+    tu.dep = lmc_swapSuffix(obj, ".d");
+    tu.stamp = lmc_swapSuffix(obj, ".sig");
+    tu.dia = lmc_swapSuffix(obj, ".dia");
+    return tu;
+}
+
+QStringList lmc_readDepFile(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return {};
+    const QByteArray data = f.readAll();
+
+    // skip "target:" -- the first colon followed by whitespace, so C:/ drive letters survive
+    int i = 0;
+    for (; i < data.size(); ++i) {
+        if (data[i] == ':' && (i + 1 == data.size() || data[i + 1] == ' ' || data[i + 1] == '\t'
+                               || data[i + 1] == '\n' || data[i + 1] == '\r'))
+            break;
+    }
+    if (i >= data.size())
+        return {};
+    ++i;
+
+    QStringList deps;
+    QByteArray cur;
+    auto flush = [&] {
+        if (!cur.isEmpty())
+            deps << QString::fromLocal8Bit(cur);
+        cur.clear();
+    };
+
+    for (; i < data.size(); ++i) {
+        const char c = data[i];
+        if (c == '\\' && i + 1 < data.size()) {
+            const char n = data[i + 1];
+            if (n == '\n' || n == '\r') { // line continuation
+                flush();
+                ++i;
+                if (n == '\r' && i + 1 < data.size() && data[i + 1] == '\n')
+                    ++i;
+                continue;
+            }
+            if (n == ' ' || n == '#' || n == '\\') {
+                cur += n;
+                ++i;
+                continue;
+            }
+            cur += c;
+        } else if (c == '$' && i + 1 < data.size() && data[i + 1] == '$') {
+            cur += '$';
+            ++i;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            flush();
+        } else {
+            cur += c;
+        }
+    }
+    flush();
+    return deps;
+}
+
+static QByteArray lmc_escapeDep(const QString &path)
+{
+    QByteArray out;
+    for (const char c : path.toLocal8Bit()) {
+        if (c == ' ' || c == '#')
+            out += '\\';
+        else if (c == '$')
+            out += '$';
+        out += c;
+    }
+    return out;
+}
+
+bool lmc_writeDepFile(const QString &path, const QString &target, const QStringList &deps)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QByteArray text = lmc_escapeDep(target) + ':';
+    for (const QString &d : deps)
+        text += " \\\n  " + lmc_escapeDep(d);
+    text += '\n';
+    return f.write(text) == text.size();
+}
+
+// Windows' cmd.exe stops at 8191 characters, the smallest limit a command line meets
+static const int kResponseFileChars = 8000;
+
+static QByteArray lmc_quoteResponseArg(const QString &arg)
+{
+    QByteArray out = "\"";
+    for (const char c : arg.toUtf8()) {
+        if (c == '\\' || c == '"')
+            out += '\\';
+        out += c;
+    }
+    return out + '"';
+}
+
+QStringList lmc_responseArgs(const QString &path, const QStringList &args)
+{
+    int length = 0;
+    for (const QString &a : args)
+        length += a.size() + 1;
+    if (length <= kResponseFileChars)
+        return args;
+
+    QByteArray text;
+    for (const QString &a : args)
+        text += lmc_quoteResponseArg(a) + '\n';
+    QFile f(path);
+    if (f.open(QIODevice::ReadOnly) && f.readAll() == text)
+        return {"@" + path};
+    f.close();
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate) || f.write(text) != text.size())
+        return args; // no file to point at, try the long command line after all
+    return {"@" + path};
+}
+
+QByteArray lmc_signature(const QString &program, const QStringList &args)
+{
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(program.toUtf8());
+    for (const QString &a : args) {
+        h.addData(QByteArray(1, '\0'));
+        h.addData(a.toUtf8());
+    }
+    return h.result().toHex();
+}
+
+QByteArray lmc_readStamp(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return {};
+    return f.readAll().trimmed();
+}
+
+bool lmc_writeStamp(const QString &path, const QByteArray &sig)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return f.write(sig + '\n') == sig.size() + 1;
+}
+
+// -1 when the file is gone
+static qint64 lmc_mtime(const QString &path, QHash<QString, qint64> &mtimes)
+{
+    auto it = mtimes.constFind(path);
+    if (it != mtimes.constEnd())
+        return it.value();
+    const QFileInfo fi(path);
+    const qint64 t = fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+    mtimes.insert(path, t);
+    return t;
+}
+
+QString lmc_dirtyReason(const LmcTuFiles &tu,
+                        const QByteArray &sig,
+                        QHash<QString, qint64> &mtimes)
+{
+    const QFileInfo objInfo(tu.obj);
+    if (!objInfo.exists())
+        return "no object";
+    if (lmc_readStamp(tu.stamp) != sig)
+        return "flags changed";
+
+    const QStringList deps = lmc_readDepFile(tu.dep);
+    if (deps.isEmpty())
+        return "no dependency info";
+
+    const qint64 objTime = objInfo.lastModified().toMSecsSinceEpoch();
+    for (const QString &d : deps) {
+        const qint64 t = lmc_mtime(d, mtimes);
+        if (t < 0)
+            return QFileInfo(d).fileName() + " is gone";
+        if (t > objTime)
+            return QFileInfo(d).fileName() + " changed";
+    }
+    return {};
+}
@@ -0,0 +1,38 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+
+// per-TU files kept next to each other in build/
+struct LmcTuFiles
+{
+    QString src;
+    QString obj;   // x-1a2b3c4d.o
+    QString dep;   // x-1a2b3c4d.d   (-MD -MF)
+    QString stamp; // x-1a2b3c4d.sig (flag signature of the last good compile)
+    QString dia;   // x-1a2b3c4d.dia (--serialize-diagnostics)
+};
+
+LmcTuFiles lmc_tuFiles(const QString &src, const QString &obj);
+
+// every prerequisite listed in a make-style depfile (source first, then headers)
+QStringList lmc_readDepFile(const QString &path);
+bool lmc_writeDepFile(const QString &path, const QString &target, const QStringList &deps);
+
+// args as-is while the command line stays short, else written to the response file at
+// path (GNU quoting, what the clang++ driver reads everywhere) and replaced by @path.
+// the file is only rewritten when its content changes
+QStringList lmc_responseArgs(const QString &path, const QStringList &args);
+
+// stable hash of a command line, used to notice flag changes
+QByteArray lmc_signature(const QString &program, const QStringList &args);
+
+QByteArray lmc_readStamp(const QString &path);
+bool lmc_writeStamp(const QString &path, const QByteArray &sig);
+
+// why the TU must be recompiled, or an empty string when its object is still good.
+// mtimes memoizes stat() results across TUs that share headers.
+QString lmc_dirtyReason(const LmcTuFiles &tu,
+                        const QByteArray &sig,
+                        QHash<QString, qint64> &mtimes);
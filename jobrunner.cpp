@@ -0,0 +1,331 @@
+// (c) 2025 Stardust Softworks
+#include "jobrunner.h"
+#include <QFile>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QTimer>
+#include <algorithm>
+#include <numeric>
+
+#if defined(Q_OS_MAC)
+#include <libproc.h>
+#include <mach/mach.h>
+#elif defined(Q_OS_WIN)
+#include <qt_windows.h>
+#include <psapi.h>
+#endif
+
+// left free for the desktop, the page cache and whatever else is running
+static const qint64 kMemoryHeadroomKb = 512 * 1024;
+// how often running jobs' memory is looked at (and a held-back job reconsidered)
+static const int kSampleMs = 250;
+
+#if defined(Q_OS_LINUX)
+// "VmHWM:   123456 kB" -> 123456
+static qint64 lmc_procKb(const QByteArray &text, const QByteArray &key)
+{
+    const int at = text.indexOf("\n" + key);
+    if (at < 0 && !text.startsWith(key))
+        return -1;
+    const int start = (at < 0 ? 0 : at + 1) + key.size();
+    const int end = text.indexOf('\n', start);
+    return text.mid(start, end < 0 ? -1 : end - start).trimmed().split(' ').value(0).toLongLong();
+}
+#endif
+
+qint64 lmc_availableMemoryKb()
+{
+#if defined(Q_OS_LINUX)
+    // the kernel's own estimate of what can be had without swapping, page cache included
+    QFile f("/proc/meminfo");
+    if (!f.open(QIODevice::ReadOnly))
+        return -1;
+    return lmc_procKb(f.readAll(), "MemAvailable:");
+#elif defined(Q_OS_MAC)
+    vm_statistics64_data_t vm;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if (host_statistics64(mach_host_self(), HOST_VM_INFO64,
+                          reinterpret_cast<host_info64_t>(&vm), &count)
+        != KERN_SUCCESS)
+        return -1;
+    vm_size_t page = 0;
+    host_page_size(mach_host_self(), &page);
+    return qint64(vm.free_count + vm.inactive_count + vm.purgeable_count) * qint64(page) / 1024;
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status))
+        return -1;
+    return qint64(status.ullAvailPhys / 1024);
+#else
+    return -1;
+#endif
+}
+
+bool lmc_processMemoryKb(qint64 pid, qint64 *rssKb, qint64 *peakKb)
+{
+#if defined(Q_OS_LINUX)
+    // clang runs cc1 in the driver's process (-fintegrated-cc1), so this is the compile
+    QFile f(QString("/proc/%1/status").arg(pid));
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray text = f.readAll();
+    *rssKb = lmc_procKb(text, "VmRSS:");
+    *peakKb = lmc_procKb(text, "VmHWM:");
+    return *rssKb >= 0 && *peakKb >= 0;
+#elif defined(Q_OS_MAC)
+    rusage_info_v4 ri;
+    if (proc_pid_rusage(int(pid), RUSAGE_INFO_V4, reinterpret_cast<rusage_info_t *>(&ri)) != 0)
+        return false;
+    *rssKb = qint64(ri.ri_phys_footprint / 1024);
+    *peakKb = qint64(ri.ri_lifetime_max_phys_footprint / 1024);
+    return true;
+#elif defined(Q_OS_WIN)
+    HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(pid));
+    if (!h)
+        return false;
+    PROCESS_MEMORY_COUNTERS pmc;
+    const bool ok = K32GetProcessMemoryInfo(h, &pmc, sizeof(pmc)) != FALSE;
+    CloseHandle(h);
+    if (!ok)
+        return false;
+    *rssKb = qint64(pmc.WorkingSetSize / 1024);
+    *peakKb = qint64(pmc.PeakWorkingSetSize / 1024);
+    return true;
+#else
+    Q_UNUSED(pid)
+    Q_UNUSED(rssKb)
+    Q_UNUSED(peakKb)
+    return false;
+#endif
+}
+
+JobRunner::JobRunner(QObject *parent)
+    : QObject(parent)
+    , m_sampler(new QTimer(this))
+{
+    m_sampler->setInterval(kSampleMs);
+    connect(m_sampler, &QTimer::timeout, this, &JobRunner::sampleMemory);
+}
+
+JobRunner::~JobRunner()
+{
+    // QProcess kills its child on destruction, just make sure nobody calls back into us
+    for (QProcess *p : std::as_const(m_procs))
+        disconnect(p, nullptr, this, nullptr);
+}
+
+void JobRunner::setMaxJobs(int n)
+{
+    m_maxJobs = qMax(1, n);
+}
+
+void JobRunner::start(const QVector<LmcJob> &jobs)
+{
+    m_jobs = jobs;
+    m_next = 0;
+    m_running = 0;
+    m_failed = false;
+    m_failureCode = 0;
+    m_cancelled = false;
+    m_finishReported = false;
+    m_peakKb.fill(0, m_jobs.size());
+    m_rssKb.fill(0, m_jobs.size());
+    m_startedMs.fill(0, m_jobs.size());
+    m_durationMs.fill(0, m_jobs.size());
+    m_clock.start();
+
+    // longest processing time first: the long ones overlap with everything else, the
+    // short ones fill in the gaps at the end
+    m_order.resize(m_jobs.size());
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+        return m_jobs.at(a).expectedMs > m_jobs.at(b).expectedMs;
+    });
+    m_memoryStalls = 0;
+    m_stalled = false;
+
+    // jobs nobody has measured yet are guessed at the median of those that were
+    QVector<qint64> known;
+    for (const LmcJob &job : std::as_const(m_jobs))
+        if (job.memoryKb > 0)
+            known << job.memoryKb;
+    std::sort(known.begin(), known.end());
+    m_guessKb = known.isEmpty() ? 0 : known.at(known.size() / 2);
+
+    if (m_jobs.isEmpty()) {
+        m_finishReported = true;
+        emit allFinished(true);
+        return;
+    }
+    if (m_memoryAware)
+        m_sampler->start();
+    launchMore();
+}
+
+void JobRunner::cancel()
+{
+    if (!isRunning())
+        return;
+    m_cancelled = true;
+    m_failed = true;
+    m_next = m_order.size();
+    for (QProcess *p : std::as_const(m_procs))
+        p->kill(); // finished() still arrives and is accounted for in onProcessDone
+}
+
+void JobRunner::launchMore()
+{
+    if (m_launching)
+        return; // the outer call's loop picks up whatever freed up
+    m_launching = true;
+    // stop feeding new work after the first failure (unless asked not to), let running jobs drain
+    while ((!m_failed || (m_keepGoing && !m_cancelled)) && m_running < m_maxJobs && m_next < m_order.size()) {
+        // one job always runs, even one that doesn't fit, or the build would never end
+        if (m_memoryAware && m_running > 0 && !memoryFits(m_jobs.at(m_order.at(m_next))))
+            break;
+        const int index = m_order.at(m_next++);
+        const LmcJob &job = m_jobs.at(index);
+
+        auto *p = new QProcess(this);
+        p->setProgram(job.program);
+        p->setArguments(job.args);
+        if (job.stdoutOnly)
+            p->setStandardErrorFile(QProcess::nullDevice());
+        else
+            p->setProcessChannelMode(QProcess::MergedChannels);
+        // nothing is ever written to a job, one that reads stdin sees EOF instead of hanging
+        p->setStandardInputFile(QProcess::nullDevice());
+        if (!job.workingDir.isEmpty())
+            p->setWorkingDirectory(job.workingDir);
+        if (!job.env.isEmpty()) {
+            QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+            for (const QString &kv : job.env)
+                env.insert(kv.section('=', 0, 0), kv.section('=', 1));
+            p->setProcessEnvironment(env);
+        }
+
+        if (job.stream) {
+            connect(p, &QProcess::readyReadStandardOutput, this, [this, p, index] {
+                emit jobOutput(index, QString::fromLocal8Bit(p->readAllStandardOutput()));
+            });
+        }
+        connect(p, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                [this, p, index](int code, QProcess::ExitStatus st) {
+                    onProcessDone(p, index, st == QProcess::NormalExit && code == 0);
+                });
+        connect(p, &QProcess::errorOccurred, this, [this, p, index](QProcess::ProcessError err) {
+            // finished() is not emitted when the program never started. start() can report that
+            // before it returns, so it's handled from the event loop, after jobStarted()
+            if (err == QProcess::FailedToStart)
+                QTimer::singleShot(0, this, [this, p, index] { onProcessDone(p, index, false); });
+        });
+
+        m_procs << p;
+        m_procIndex.insert(p, index);
+        m_startedMs[index] = m_clock.elapsed();
+        ++m_running;
+        emit jobStarted(index);
+        p->start();
+    }
+    m_launching = false;
+
+    // once per start(); a slot on allFinished may start() the next batch right away
+    if (m_running == 0 && !m_finishReported) {
+        m_finishReported = true;
+        m_sampler->stop();
+        emit allFinished(!m_failed);
+    }
+}
+
+// the job fits when its expected peak, plus what the running ones are still expected to
+// grow by, leaves the headroom free. memoryStalled() fires once per stretch of waiting
+bool JobRunner::memoryFits(const LmcJob &job)
+{
+    const qint64 available = lmc_availableMemoryKb();
+    if (available < 0) {
+        m_stalled = false;
+        return true;
+    }
+    qint64 growth = 0;
+    for (auto it = m_procIndex.cbegin(); it != m_procIndex.cend(); ++it) {
+        const LmcJob &running = m_jobs.at(it.value());
+        const qint64 expected = running.memoryKb > 0 ? running.memoryKb : m_guessKb;
+        growth += qMax<qint64>(0, expected - m_rssKb.at(it.value()));
+    }
+    const qint64 needed = job.memoryKb > 0 ? job.memoryKb : m_guessKb;
+    const qint64 spare = available - growth - kMemoryHeadroomKb;
+    if (needed <= spare) {
+        m_stalled = false;
+        return true;
+    }
+    if (!m_stalled) {
+        m_stalled = true;
+        ++m_memoryStalls;
+        emit memoryStalled(needed, qMax<qint64>(0, spare));
+    }
+    return false;
+}
+
+// a list schedule over the job slots: running jobs end when expected (one that overran its
+// estimate any moment now), each queued one goes to the slot that frees up first
+qint64 JobRunner::remainingMs() const
+{
+    if (!isRunning())
+        return 0;
+    const qint64 now = m_clock.elapsed();
+    QVector<qint64> lanes;
+    for (auto it = m_procIndex.cbegin(); it != m_procIndex.cend(); ++it) {
+        const int index = it.value();
+        lanes << qMax<qint64>(0, m_jobs.at(index).expectedMs - (now - m_startedMs.at(index)));
+    }
+    while (lanes.size() < m_maxJobs)
+        lanes << 0;
+    for (int i = m_next; i < m_order.size(); ++i)
+        *std::min_element(lanes.begin(), lanes.end()) += m_jobs.at(m_order.at(i)).expectedMs;
+    return *std::max_element(lanes.begin(), lanes.end());
+}
+
+void JobRunner::sampleMemory()
+{
+    for (auto it = m_procIndex.cbegin(); it != m_procIndex.cend(); ++it) {
+        const qint64 pid = it.key()->processId();
+        qint64 rss = 0;
+        qint64 peak = 0;
+        if (pid <= 0 || !lmc_processMemoryKb(pid, &rss, &peak))
+            continue;
+        m_rssKb[it.value()] = rss;
+        m_peakKb[it.value()] = qMax(m_peakKb.at(it.value()), qMax(rss, peak));
+    }
+    // memory may have come free since the last try (a job shrank, something else quit)
+    if (m_stalled)
+        launchMore();
+}
+
+void JobRunner::onProcessDone(QProcess *p, int index, bool ok)
+{
+    QString output = QString::fromLocal8Bit(p->readAllStandardOutput());
+    if (!m_jobs.at(index).stdoutOnly) {
+        if (p->error() == QProcess::FailedToStart)
+            output += "❌ Failed to start: " + p->program() + "\n";
+        else if (m_cancelled)
+            output += "Cancelled\n";
+        else if (!ok)
+            output += "Exited with code " + QString::number(p->exitCode()) + "\n";
+    }
+    m_procs.removeOne(p);
+    m_procIndex.remove(p);
+    m_durationMs[index] = m_clock.elapsed() - m_startedMs.at(index);
+    p->deleteLater();
+
+    --m_running;
+    if (!ok && !m_failed)
+        m_failureCode = p->exitStatus() == QProcess::NormalExit && p->error() != QProcess::FailedToStart
+                            ? p->exitCode()
+                            : -1;
+    if (!ok)
+        m_failed = true;
+
+    emit jobFinished(index, ok, output);
+    launchMore();
+}
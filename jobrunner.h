@@ -0,0 +1,107 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+class QProcess;
+class QTimer;
+
+// one process in a parallel batch (usually a single -c compile)
+struct LmcJob
+{
+    QString label; // shown as the log header for this job
+    QString program;
+    QStringList args;
+    bool stream = false; // forward output as it arrives instead of one block at exit
+    bool stdoutOnly = false; // output is stdout alone: stderr dropped, no status line added
+    QString workingDir;  // empty: inherit
+    QStringList env;     // KEY=value, on top of the inherited environment
+    qint64 memoryKb = 0; // expected peak RSS (an earlier build's), 0: unknown
+    qint64 expectedMs = 0; // expected run time, longer jobs start first
+};
+
+// memory the system can hand out without swapping (MemAvailable on Linux), -1: can't tell
+qint64 lmc_availableMemoryKb();
+// a running process's resident memory now and at its peak so far, false when unreadable
+bool lmc_processMemoryKb(qint64 pid, qint64 *rssKb, qint64 *peakKb);
+
+// runs a queue of jobs with at most maxJobs processes alive at once, driven
+// purely by QProcess signals so the GUI thread never blocks on a child.
+// each job's stdout+stderr is buffered and handed over in one piece when it
+// exits so the build log never interleaves two TUs. jobs launch longest first
+// (by expectedMs, ties in queue order) so no slow one is left running alone at the end.
+// memory-aware mode also holds a job back while its expected memory wouldn't fit, so
+// a few heavy TUs side by side can't push the machine into swap.
+class JobRunner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit JobRunner(QObject *parent = nullptr);
+    ~JobRunner();
+
+    void setMaxJobs(int n);
+    int maxJobs() const { return m_maxJobs; }
+    // keep launching queued jobs after one fails (allFinished still reports the failure)
+    void setKeepGoing(bool on) { m_keepGoing = on; }
+    // admit jobs by memory as well as by count, and sample each job's peak RSS
+    void setMemoryAware(bool on) { m_memoryAware = on; }
+
+    void start(const QVector<LmcJob> &jobs);
+    const QVector<LmcJob> &jobs() const { return m_jobs; }
+    bool isRunning() const { return m_running > 0 || m_next < m_order.size(); }
+    // when the last job should be done, from the expected run times, 0 when idle
+    qint64 remainingMs() const;
+
+    // kill everything in flight and drop the queue, allFinished(false) follows
+    void cancel();
+    bool wasCancelled() const { return m_cancelled; }
+    // exit code of the first job that failed, -1 when it crashed or never started
+    int failureCode() const { return m_failureCode; }
+    // highest RSS seen while the job ran (sampled, memory-aware mode only), 0: none seen
+    qint64 peakRssKb(int index) const { return m_peakKb.value(index); }
+    // how long a finished job took, 0 for one that didn't run
+    qint64 durationMs(int index) const { return m_durationMs.value(index); }
+    // times a job was held back for memory since start()
+    int memoryStalls() const { return m_memoryStalls; }
+
+signals:
+    void jobStarted(int index);
+    void jobOutput(int index, const QString &chunk); // stream jobs only
+    void jobFinished(int index, bool ok, const QString &output);
+    void allFinished(bool ok);
+    // the next job was held back: it needs about neededKb, availableKb is free
+    void memoryStalled(qint64 neededKb, qint64 availableKb);
+
+private:
+    void launchMore();
+    void onProcessDone(QProcess *p, int index, bool ok);
+    bool memoryFits(const LmcJob &job);
+    void sampleMemory();
+
+    QVector<LmcJob> m_jobs;
+    QVector<int> m_order; // launch order, indexes into m_jobs
+    QList<QProcess *> m_procs;
+    QHash<QProcess *, int> m_procIndex;
+    QTimer *m_sampler;
+    QVector<qint64> m_peakKb;
+    QVector<qint64> m_rssKb;  // latest sample per job
+    QElapsedTimer m_clock;    // since start()
+    QVector<qint64> m_startedMs;
+    QVector<qint64> m_durationMs;
+    qint64 m_guessKb = 0;     // expected peak of jobs without history
+    int m_memoryStalls = 0;
+    bool m_stalled = false;
+    bool m_memoryAware = false;
+    int m_maxJobs = 1;
+    int m_next = 0; // into m_order
+    int m_running = 0;
+    int m_failureCode = 0;
+    bool m_failed = false;
+    bool m_keepGoing = false;
+    bool m_cancelled = false;
+    bool m_launching = false;      // inside launchMore()
+    bool m_finishReported = false; // allFinished went out for this start()
+};
@@ -0,0 +1,126 @@
+// (c) 2025 Stardust Softworks
+#include "libregistry.h"
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+
+static QStringList lmc_jsonStrings(const QJsonValue &v)
+{
+    QStringList out;
+    for (const QJsonValue &x : v.toArray())
+        out << x.toString();
+    return out;
+}
+
+bool LmcLibrary::matchesInclude(const QString &include) const
+{
+    for (const QString &pat : includes) {
+        if (pat.endsWith('/')) {
+            if (include.startsWith(pat))
+                return true;
+        } else if (pat.startsWith('*')) {
+            if (include.endsWith(pat.mid(1)))
+                return true;
+        } else if (include == pat) {
+            return true;
+        }
+    }
+    return false;
+}
+
+LibraryRegistry::LibraryRegistry()
+{
+    loadFile(":/data/libraries.json");
+    loadFile(userFile());
+}
+
+QString LibraryRegistry::userFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/libraries.json";
+}
+
+void LibraryRegistry::loadFile(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return;
+    const QJsonArray list = QJsonDocument::fromJson(f.readAll()).object().value("libraries").toArray();
+    for (const QJsonValue &v : list) {
+        const QJsonObject o = v.toObject();
+        LmcLibrary lib;
+        lib.name = o.value("name").toString();
+        if (lib.name.isEmpty())
+            continue;
+        lib.includes = lmc_jsonStrings(o.value("includes"));
+        lib.depends = lmc_jsonStrings(o.value("requires"));
+        lib.config = o.value("config").toString();
+        lib.pkgconfig = lmc_jsonStrings(o.value("pkgconfig"));
+        lib.brew = o.value("brew").toString();
+        lib.libs = lmc_jsonStrings(o.value("libs"));
+        lib.macIncludeDirs = lmc_jsonStrings(o.value("macIncludeDirs"));
+        lib.macLibDirs = lmc_jsonStrings(o.value("macLibDirs"));
+        lib.winEnvDir = o.value("winEnvDir").toString();
+        lib.winLibs = lmc_jsonStrings(o.value("winLibs"));
+
+        bool replaced = false;
+        for (LmcLibrary &existing : m_libs) {
+            if (existing.name == lib.name) {
+                existing = lib;
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced)
+            m_libs << lib;
+    }
+}
+
+QVector<LmcLibrary> LibraryRegistry::detect(const QSet<QString> &includes) const
+{
+    QSet<QString> wanted;
+    for (const QString &inc : includes)
+        for (const LmcLibrary &lib : m_libs)
+            if (!wanted.contains(lib.name) && lib.matchesInclude(inc))
+                wanted.insert(lib.name);
+
+    // close over requires
+    QStringList todo(wanted.cbegin(), wanted.cend());
+    while (!todo.isEmpty()) {
+        const QString name = todo.takeLast();
+        for (const LmcLibrary &lib : m_libs) {
+            if (lib.name != name)
+                continue;
+            for (const QString &dep : lib.depends) {
+                if (!wanted.contains(dep)) {
+                    wanted.insert(dep);
+                    todo << dep;
+                }
+            }
+        }
+    }
+
+    QVector<LmcLibrary> out;
+    for (const LmcLibrary &lib : m_libs)
+        if (wanted.contains(lib.name))
+            out << lib;
+    return out;
+}
+
+QStringList LibraryRegistry::probeCommands(const QVector<LmcLibrary> &libs)
+{
+    QStringList cmds;
+    for (const LmcLibrary &lib : libs) {
+        if (!lib.config.isEmpty())
+            cmds << (lib.config + " --cflags") << (lib.config + " --libs");
+        for (const QString &pkg : lib.pkgconfig)
+            cmds << ("pkg-config --cflags " + pkg) << ("pkg-config --libs " + pkg);
+#ifdef Q_OS_MAC
+        if (!lib.brew.isEmpty())
+            cmds << ("brew --prefix " + lib.brew);
+#endif
+    }
+    return cmds;
+}
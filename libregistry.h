@@ -0,0 +1,46 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+// one auto-detected dependency. the built-in table is libraries.json (bundled as
+// :/data/libraries.json); a libraries.json in the user's config dir with the same
+// format adds entries or replaces built-ins of the same name, no rebuild needed.
+struct LmcLibrary
+{
+    QString name;
+    QStringList includes;  // "Dir/" any header under Dir, "*name" suffix match, else exact
+    QStringList depends;   // other entries pulled in with this one ("requires")
+    QString config;        // foo-config tool asked for --cflags / --libs
+    QStringList pkgconfig; // packages asked for --cflags / --libs
+    QString brew;          // macOS: -I/-L from `brew --prefix <formula>`
+    QStringList libs;      // added when the probes didn't already provide them
+    QStringList macIncludeDirs;
+    QStringList macLibDirs;
+    QString winEnvDir;     // Windows: <env>/include and <env>/lib
+    QStringList winLibs;
+
+    bool matchesInclude(const QString &include) const;
+};
+
+class LibraryRegistry
+{
+public:
+    LibraryRegistry();
+
+    const QVector<LmcLibrary> &libraries() const { return m_libs; }
+
+    // entries any of the includes refer to, plus what they require, in table order
+    QVector<LmcLibrary> detect(const QSet<QString> &includes) const;
+
+    // every shell probe the flag assembly for these libraries can ask for
+    static QStringList probeCommands(const QVector<LmcLibrary> &libs);
+
+    static QString userFile();
+
+private:
+    void loadFile(const QString &path);
+
+    QVector<LmcLibrary> m_libs;
+};
@@ -0,0 +1,86 @@
+// (c) 2025 Stardust Softworks
+#include "linker.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+QVector<LmcLinker> lmc_findLinkers(const QString &compiler)
+{
+    QString compilerPath = compiler;
+    if (!QFileInfo(compiler).isAbsolute())
+        compilerPath = QStandardPaths::findExecutable(compiler);
+    const QStringList nextToCompiler{QFileInfo(compilerPath).absolutePath()};
+
+    // binary names clang looks for behind -fuse-ld=<name> on this platform
+#ifdef Q_OS_WIN
+    const QVector<QPair<QString, QString>> candidates{{"lld", "lld-link"}};
+#elif defined(Q_OS_MAC)
+    const QVector<QPair<QString, QString>> candidates{{"lld", "ld64.lld"}};
+#else
+    const QVector<QPair<QString, QString>> candidates{{"mold", "ld.mold"}, {"lld", "ld.lld"}};
+#endif
+
+    QVector<LmcLinker> found;
+    for (const auto &c : candidates) {
+        QString path;
+        if (!compilerPath.isEmpty())
+            path = QStandardPaths::findExecutable(c.second, nextToCompiler);
+        if (path.isEmpty())
+            path = QStandardPaths::findExecutable(c.second);
+        if (!path.isEmpty())
+            found << LmcLinker{c.first, path, c.first};
+    }
+    return found;
+}
+
+LmcLinker lmc_pickLinker(const QVector<LmcLinker> &found, const QString &wanted, QString *note)
+{
+    if (wanted == "auto") {
+        if (!found.isEmpty()) {
+            *note = found.first().name + " (" + found.first().path + ")";
+            return found.first();
+        }
+        *note = "default (no lld or mold found)";
+        return {};
+    }
+    if (wanted == "lld" || wanted == "mold") {
+        for (const LmcLinker &l : found) {
+            if (l.name == wanted) {
+                *note = l.name + " (" + l.path + ")";
+                return l;
+            }
+        }
+        *note = "default (⚠️ " + wanted + " not found)";
+        return {};
+    }
+    *note = "default";
+    return {};
+}
+
+QStringList lmc_thinLtoCacheFlags(const LmcLinker &linker, const QString &dir, int maxMB)
+{
+    const QString policy = "cache_size_bytes=" + QString::number(maxMB) + "m";
+#ifdef Q_OS_WIN
+    Q_UNUSED(linker)
+    return {"-Wl,/lldltocache:" + dir, "-Wl,/lldltocachepolicy:" + policy};
+#elif defined(Q_OS_MAC)
+    // ld64 only knows a share of the free disk space
+    if (linker.name != "lld")
+        return {"-Wl,-cache_path_lto," + dir, "-Wl,-max_relative_cache_size_lto,10"};
+    return {"-Wl,-cache_path_lto," + dir, "-Wl,--thinlto-cache-policy=" + policy};
+#else
+    if (linker.name == "lld")
+        return {"-Wl,--thinlto-cache-dir=" + dir, "-Wl,--thinlto-cache-policy=" + policy};
+    // mold and GNU ld hand LTO to the LLVMgold plugin
+    return {"-Wl,-plugin-opt=cache-dir=" + dir, "-Wl,-plugin-opt=cache-policy=" + policy};
+#endif
+}
+
+QSet<QString> lmc_thinLtoCacheEntries(const QString &dir)
+{
+    QSet<QString> entries;
+    const QStringList names = QDir(dir).entryList({"llvmcache-*"}, QDir::Files);
+    for (const QString &n : names)
+        entries.insert(n);
+    return entries;
+}
@@ -0,0 +1,27 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// a linker clang can be pointed at with -fuse-ld
+struct LmcLinker
+{
+    QString name;   // "mold", "lld"
+    QString path;
+    QString fuseLd; // -fuse-ld=<this>
+};
+
+// fast linkers that are installed, fastest first. looked for next to the compiler
+// first (an LLVM toolchain ships its own ld.lld), then on PATH.
+QVector<LmcLinker> lmc_findLinkers(const QString &compiler);
+
+// the linker for a "linker" setting: "auto" (fastest found), "lld", "mold", anything
+// else means clang's default. *note says what was chosen, or why the wish wasn't met.
+LmcLinker lmc_pickLinker(const QVector<LmcLinker> &found, const QString &wanted, QString *note);
+
+// link flags that keep ThinLTO backend output in dir, one entry per module, pruned
+// by the linker once it holds more than maxMB. spelled for whichever linker runs.
+QStringList lmc_thinLtoCacheFlags(const LmcLinker &linker, const QString &dir, int maxMB);
+// the entries currently in a ThinLTO cache dir, to tell reused modules from new ones
+QSet<QString> lmc_thinLtoCacheEntries(const QString &dir);
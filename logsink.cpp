@@ -0,0 +1,110 @@
+// (c) 2025 Stardust Softworks
+#include "logsink.h"
+#include <QFileInfo>
+
+LogSink::LogSink(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(33); // ~30 Hz
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &LogSink::flush);
+}
+
+void LogSink::append(const QString &s)
+{
+    if (s.isEmpty())
+        return;
+
+    if (m_spill.isOpen())
+        m_spill.write(s.toUtf8());
+
+    m_pending += s;
+    // trim in big steps so a flood doesn't shift the buffer on every chunk
+    if (m_pending.size() > 2 * m_maxPending) {
+        const int excess = m_pending.size() - m_maxPending;
+        m_pending.remove(0, excess);
+        m_dropped += excess;
+    }
+
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void LogSink::flush()
+{
+    m_timer.stop();
+    if (m_spill.isOpen())
+        m_spill.flush();
+    if (m_pending.isEmpty() && m_dropped == 0)
+        return;
+
+    if (m_pending.size() > m_maxPending) {
+        const int excess = m_pending.size() - m_maxPending;
+        m_pending.remove(0, excess);
+        m_dropped += excess;
+    }
+
+    QString text;
+    if (m_dropped > 0) {
+        text = QString("\n… %1 KB of output skipped").arg((m_dropped + 1023) / 1024);
+        if (m_spill.isOpen())
+            text += ", full log: " + QFileInfo(m_spill).absoluteFilePath();
+        text += " …\n";
+        m_column = 0;
+        // resume at a line start
+        const int nl = m_pending.indexOf('\n');
+        if (nl >= 0)
+            m_pending.remove(0, nl + 1);
+    }
+    text += clipLongLines(m_pending);
+
+    m_pending.clear();
+    m_dropped = 0;
+    emit flushed(text);
+}
+
+void LogSink::clear()
+{
+    m_timer.stop();
+    m_pending.clear();
+    m_dropped = 0;
+    m_column = 0;
+}
+
+void LogSink::setSpillFile(const QString &path)
+{
+    if (m_spill.isOpen())
+        m_spill.close();
+    if (path.isEmpty())
+        return;
+    m_spill.setFileName(path);
+    if (!m_spill.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        m_spill.setFileName(QString());
+}
+
+QString LogSink::clipLongLines(const QString &text)
+{
+    QString out;
+    out.reserve(text.size());
+    int from = 0;
+    while (from < text.size()) {
+        int nl = text.indexOf('\n', from);
+        const int end = nl < 0 ? text.size() : nl;
+        const int len = end - from;
+
+        if (m_column < m_maxLine) {
+            const int room = m_maxLine - m_column;
+            out.append(text.constData() + from, qMin(len, room));
+            if (len > room)
+                out += " …[line clipped]";
+        }
+        m_column += len;
+
+        if (nl < 0)
+            break;
+        out += '\n';
+        m_column = 0;
+        from = nl + 1;
+    }
+    return out;
+}
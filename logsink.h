@@ -0,0 +1,41 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+
+// batches build output for the log view. append() is cheap and may be called
+// for every chunk a compiler prints; the view only hears about it ~30 times a
+// second through flushed(). whatever piles up between two flushes is capped,
+// the oldest part is dropped, and the complete text goes to a spill file.
+class LogSink : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogSink(QObject *parent = nullptr);
+
+    void append(const QString &s);
+    void flush();
+    void clear();
+
+    // full log copy, empty path closes it
+    void setSpillFile(const QString &path);
+    QString spillFile() const { return m_spill.fileName(); }
+
+    void setMaxPendingChars(int n) { m_maxPending = n; }
+    void setMaxLineChars(int n) { m_maxLine = n; }
+
+signals:
+    void flushed(const QString &text);
+
+private:
+    QString clipLongLines(const QString &text);
+
+    QTimer m_timer;
+    QFile m_spill;
+    QString m_pending;
+    qint64 m_dropped = 0;     // chars skipped since the last flush
+    int m_maxPending = 1 << 20;
+    int m_maxLine = 4096;     // the view chokes on megabyte-long lines
+    int m_column = 0;         // length of the last line already flushed
+};
@@ -1,16 +1,29 @@
 // (C) 2025 Stardust Softworks
 #include "mainwindow.h"
+#include "cli.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QLocale>
 #include <QTranslator>
 #include <QCoreApplication>
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer sinceLaunch;
+    sinceLaunch.start();
+
     QCoreApplication::setOrganizationName("StardustSoftworks");
     QCoreApplication::setApplicationName("LazyMansClang");
 
+    // scripted builds: QCoreApplication only, no widgets, no translator, no window
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--build") == 0) {
+            QCoreApplication app(argc, argv);
+            return lmc_runCli(app.arguments(), sinceLaunch);
+        }
+    }
+
     QApplication a(argc, argv);
 
     QTranslator translator;
@@ -1,22 +1,70 @@
 // (c) 2025 Stardust Softworks
 #include "mainwindow.h"
 #include <QAction>
+#include <QActionGroup>
 #include <QDir>
+#include <QDockWidget>
 #include <QFile>
-#include <QFileDevice>
 #include <QFileDialog>
 #include <QFileInfo>
-#include <QListWidgetItem>
+#include <QInputDialog>
+#include <QItemSelectionModel>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QProcess>
-#include <QRegularExpression>
+#include <QProgressBar>
+#include <QScrollBar>
 #include <QSettings>
+#include <QStandardPaths>
+#include <QStatusBar>
 #include <QTextCursor>
 #include <QTextStream>
+#include <QThread>
+#include <QTimer>
 #include "aboutdialog.h"
+#include "buildengine.h"
+#include "buildwatcher.h"
+#include "compilecache.h"
+#include "diagnosticsview.h"
+#include "logsink.h"
+#include "pgo.h"
+#include "profiles.h"
+#include "remarksview.h"
+#include "runbench.h"
+#include "sourcelist.h"
 #include "ui_mainwindow.h"
 
+// lines kept in the output view, older ones scroll away (the spill file keeps everything)
+static const int kMaxLogBlocks = 20000;
+
+// console programs want a terminal to print to, each platform has its own way to get one
+static bool lmc_launchInTerminal(const QString &program)
+{
+    const QString dir = QFileInfo(program).absolutePath();
+#if defined(Q_OS_MAC)
+    return QProcess::startDetached("/usr/bin/open", {"-a", "Terminal", program}, dir);
+#elif defined(Q_OS_WIN)
+    // start gives it a console window of its own, a detached child of a GUI app gets none
+    return QProcess::startDetached("cmd.exe", {"/c", "start", "", program}, dir);
+#else
+    // Debian's alternatives entry first, then the usual suspects and how each takes a command
+    const QList<QPair<QString, QStringList>> terminals{{"x-terminal-emulator", {"-e"}},
+                                                       {"gnome-terminal", {"--"}},
+                                                       {"konsole", {"-e"}},
+                                                       {"xfce4-terminal", {"-x"}},
+                                                       {"kitty", {}},
+                                                       {"alacritty", {"-e"}},
+                                                       {"xterm", {"-e"}}};
+    for (const auto &t : terminals) {
+        const QString path = QStandardPaths::findExecutable(t.first);
+        if (!path.isEmpty())
+            return QProcess::startDetached(path, t.second + QStringList{program}, dir);
+    }
+    // no terminal at all: it still runs, its output goes wherever ours does
+    return QProcess::startDetached(program, {}, dir);
+#endif
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
@@ -24,6 +72,8 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
     setWindowTitle("LazyMansClang");
     this->setWindowIcon(QIcon(":/icons/256x256.png"));
+    sources = new SourceListModel(this);
+    ui->fileList->setModel(sources);
 
     // load saved compiler path if any found
     QSettings settings("StardustSoftworks", "LazyMansClang");
@@ -41,6 +91,65 @@ MainWindow::MainWindow(QWidget *parent)
 #endif
     }
 
+    // parallel jobs, defaults to one per hardware thread
+    ui->jobsSpin->setValue(settings.value("jobs", QThread::idealThreadCount()).toInt());
+    connect(ui->jobsSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [](int n) {
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("jobs", n);
+    });
+
+    // the output view only ever sees batched, capped text
+    ui->outputBox->setMaximumBlockCount(kMaxLogBlocks);
+    ui->outputBox->setUndoRedoEnabled(false);
+    engine = new BuildEngine(this);
+    connect(engine->logSink(), &LogSink::flushed, this, &MainWindow::writeLogBatch);
+    connect(engine, &BuildEngine::finished, this, &MainWindow::onBuildFinished);
+    pgo = new PgoWorkflow(engine, this);
+    // warnings and errors as a table next to the raw log, one row per distinct one
+    diagnostics = new DiagnosticsView(this);
+    diagnosticsDock = new QDockWidget(tr("Diagnostics"), this);
+    diagnosticsDock->setObjectName("diagnosticsDock");
+    diagnosticsDock->setWidget(diagnostics);
+    addDockWidget(Qt::BottomDockWidgetArea, diagnosticsDock);
+    connect(engine, &BuildEngine::diagnostics, diagnostics, &DiagnosticsView::add);
+    // missed optimizations, filled when a build asked for remarks, a tab next to the above
+    remarks = new RemarksView(this);
+    remarksDock = new QDockWidget(tr("Optimization Remarks"), this);
+    remarksDock->setObjectName("remarksDock");
+    remarksDock->setWidget(remarks);
+    addDockWidget(Qt::BottomDockWidgetArea, remarksDock);
+    tabifyDockWidget(diagnosticsDock, remarksDock);
+    diagnosticsDock->raise();
+    connect(engine, &BuildEngine::optimizationRemarks, this,
+            [this](const QVector<LmcRemark> &list) {
+        remarks->setRemarks(list);
+        if (!list.isEmpty())
+            remarksDock->raise();
+    });
+    connect(pgo, &PgoWorkflow::finished, this, &MainWindow::onBuildFinished);
+    // compiles done and the time left, going by how long each TU took last time
+    buildProgress = new QProgressBar(this);
+    buildProgress->setMaximumWidth(320);
+    buildProgress->hide();
+    statusBar()->addPermanentWidget(buildProgress);
+    etaTimer = new QTimer(this);
+    etaTimer->setInterval(1000);
+    connect(etaTimer, &QTimer::timeout, this, &MainWindow::showEta);
+    connect(engine, &BuildEngine::progress, this, &MainWindow::onBuildProgress);
+    usePch = settings.value("pch", false).toBool();
+    useUnity = settings.value("unity", false).toBool();
+    unityBatch = settings.value("unityBatch", 0).toInt();
+    pgoRuns = settings.value("pgoRuns").toStringList();
+    benchmark = new RunBenchmark(this);
+    connect(benchmark, &RunBenchmark::finished, this, &MainWindow::onBenchmarkFinished);
+    connect(benchmark, &RunBenchmark::progress, this, [this](int done, int total) {
+        statusBar()->showMessage(tr("Benchmark: %1 of %2 run(s) done…").arg(done).arg(total));
+    });
+    benchRuns = settings.value("benchRuns", 10).toInt();
+    benchWarmup = settings.value("benchWarmup", 2).toInt();
+    benchArgs = settings.value("benchArgs").toString();
+    profile = settings.value("profile").toString();
+
     // save compiler path if edited
     connect(ui->compilerPathInput, &QLineEdit::editingFinished, this, [this] {
         QString path = ui->compilerPathInput->text().trimmed();
@@ -60,16 +169,171 @@ MainWindow::MainWindow(QWidget *parent)
 
     // add to any menu -- Qt(sucks) will relocate on macOS
     QMenu *appMenu = menuBar()->addMenu(tr("&App"));
+    QAction *openAct = appMenu->addAction(tr("Open Project…"));
+    connect(openAct, &QAction::triggered, this, &MainWindow::openProject);
+    QAction *saveAct = appMenu->addAction(tr("Save Project…"));
+    connect(saveAct, &QAction::triggered, this, &MainWindow::saveProject);
+    appMenu->addSeparator();
+    appMenu->addAction(diagnosticsDock->toggleViewAction());
+    appMenu->addAction(remarksDock->toggleViewAction());
+    appMenu->addSeparator();
     appMenu->addAction(aboutAct);
 
+    // build options
+    QMenu *buildMenu = menuBar()->addMenu(tr("&Build"));
+    profileMenu = buildMenu->addMenu(tr("Profile"));
+    fillProfileMenu();
+    // rebuild on save, not persisted: nobody wants a build kicked off by opening the app
+    watcher = new BuildWatcher(this);
+    connect(watcher, &BuildWatcher::changed, this, &MainWindow::onWatchedFilesChanged);
+    watchAct = buildMenu->addAction(tr("Watch Mode"));
+    watchAct->setCheckable(true);
+    connect(watchAct, &QAction::toggled, this, &MainWindow::setWatching);
+    buildMenu->addSeparator();
+    QAction *cacheAct = buildMenu->addAction(tr("Use Compile Cache"));
+    cacheAct->setCheckable(true);
+    cacheAct->setChecked(engine->compileCache()->isEnabled());
+    connect(cacheAct, &QAction::toggled, this, [this](bool on) {
+        engine->compileCache()->setEnabled(on);
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("compileCache", on);
+    });
+    connect(buildMenu->addAction(tr("Compile Cache Size…")), &QAction::triggered, this, [this] {
+        bool ok = false;
+        const int mb = QInputDialog::getInt(this,
+                                            tr("Compile Cache Size"),
+                                            tr("Maximum size (MB):"),
+                                            int(engine->compileCache()->maxBytes() / (1024 * 1024)),
+                                            64,
+                                            1024 * 1024,
+                                            256,
+                                            &ok);
+        if (!ok)
+            return;
+        engine->compileCache()->setMaxBytes(qint64(mb) * 1024 * 1024);
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("cacheMaxMB", mb);
+    });
+    connect(buildMenu->addAction(tr("Clear Compile Cache")), &QAction::triggered, this, [this] {
+        engine->compileCache()->clear();
+        appendLog("Compile cache cleared: " + engine->compileCache()->root() + "\n");
+    });
+    buildMenu->addSeparator();
+    pchAct = buildMenu->addAction(tr("Precompile Common Headers"));
+    pchAct->setCheckable(true);
+    pchAct->setChecked(usePch);
+    connect(pchAct, &QAction::toggled, this, [this](bool on) {
+        usePch = on;
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("pch", on);
+    });
+    unityAct = buildMenu->addAction(tr("Unity Build"));
+    unityAct->setCheckable(true);
+    unityAct->setChecked(useUnity);
+    connect(unityAct, &QAction::toggled, this, [this](bool on) {
+        useUnity = on;
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("unity", on);
+    });
+    connect(buildMenu->addAction(tr("Unity Batch Size…")), &QAction::triggered, this, [this] {
+        bool ok = false;
+        const int n = QInputDialog::getInt(this,
+                                           tr("Unity Batch Size"),
+                                           tr("Sources per batch (0 = automatic):"),
+                                           unityBatch,
+                                           0,
+                                           1000,
+                                           1,
+                                           &ok);
+        if (!ok)
+            return;
+        unityBatch = n;
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("unityBatch", n);
+    });
+    buildMenu->addSeparator();
+    timeTraceAct = buildMenu->addAction(tr("Time Trace Report"));
+    timeTraceAct->setCheckable(true);
+    timeTraceAct->setChecked(settings.value("timeTrace", false).toBool());
+    connect(timeTraceAct, &QAction::toggled, this, [](bool on) {
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("timeTrace", on);
+    });
+    optRemarksAct = buildMenu->addAction(tr("Optimization Remarks"));
+    optRemarksAct->setCheckable(true);
+    optRemarksAct->setChecked(settings.value("optRemarks", false).toBool());
+    optRemarksAct->setToolTip(tr("-fsave-optimization-record, needs an -O level"));
+    connect(optRemarksAct, &QAction::toggled, this, [](bool on) {
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("optRemarks", on);
+    });
+
+    // link time: a faster linker, and debug info that's cheaper to link (ELF only)
+    buildMenu->addSeparator();
+    thinLtoAct = buildMenu->addAction(tr("Release + ThinLTO"));
+    thinLtoAct->setCheckable(true);
+    thinLtoAct->setChecked(settings.value("thinLto", false).toBool());
+    thinLtoAct->setToolTip(tr("-O2 -DNDEBUG -flto=thin, unchanged modules come from a cache"));
+    connect(thinLtoAct, &QAction::toggled, this, [](bool on) {
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("thinLto", on);
+    });
+    connect(buildMenu->addAction(tr("Profile-Guided Build…")), &QAction::triggered, this,
+            &MainWindow::buildWithProfile);
+    connect(buildMenu->addAction(tr("Build and Benchmark")), &QAction::triggered, this,
+            &MainWindow::buildAndBenchmark);
+    connect(buildMenu->addAction(tr("Benchmark Settings…")), &QAction::triggered, this,
+            &MainWindow::benchmarkSettings);
+    QMenu *linkerMenu = buildMenu->addMenu(tr("Linker"));
+    linkerGroup = new QActionGroup(this);
+    const QString linker = settings.value("linker", "default").toString();
+    const QList<QPair<QString, QString>> linkers{{tr("Fastest Available"), "auto"},
+                                                 {tr("Clang Default"), "default"},
+                                                 {tr("lld"), "lld"},
+                                                 {tr("mold"), "mold"}};
+    for (const auto &l : linkers) {
+        QAction *a = linkerMenu->addAction(l.first);
+        a->setCheckable(true);
+        a->setData(l.second);
+        a->setChecked(l.second == linker);
+        linkerGroup->addAction(a);
+    }
+    connect(linkerGroup, &QActionGroup::triggered, this, [](QAction *a) {
+        QSettings settings("StardustSoftworks", "LazyMansClang");
+        settings.setValue("linker", a->data().toString());
+    });
+    splitDwarfAct = buildMenu->addAction(tr("Split DWARF"));
+    gdbIndexAct = buildMenu->addAction(tr("GDB Index"));
+    compressDebugAct = buildMenu->addAction(tr("Compress Debug Sections"));
+    const QList<QPair<QAction *, QString>> debugActs{{splitDwarfAct, "splitDwarf"},
+                                                     {gdbIndexAct, "gdbIndex"},
+                                                     {compressDebugAct, "compressDebug"}};
+    for (const auto &d : debugActs) {
+        QAction *a = d.first;
+        const QString key = d.second;
+        a->setCheckable(true);
+        a->setChecked(settings.value(key, false).toBool());
+        a->setToolTip(tr("Only when the C++ flags ask for debug info (-g)"));
+#if defined(Q_OS_MAC) || defined(Q_OS_WIN)
+        a->setEnabled(false);
+#endif
+        connect(a, &QAction::toggled, this, [key](bool on) {
+            QSettings settings("StardustSoftworks", "LazyMansClang");
+            settings.setValue(key, on);
+        });
+    }
+    buildMenu->setToolTipsVisible(true);
+
     // signals | slots
     connect(ui->addFilesButton, &QPushButton::clicked, this, &MainWindow::addFiles);
+    connect(ui->addFolderButton, &QPushButton::clicked, this, &MainWindow::addFolder);
     connect(ui->removeFilesButton, &QPushButton::clicked, this, &MainWindow::removeSelectedFiles);
     connect(ui->clearFilesButton, &QPushButton::clicked, this, &MainWindow::clearFiles);
     connect(ui->browseCompilerButton, &QPushButton::clicked, this, &MainWindow::browseCompiler);
     connect(ui->browseOutputPath, &QPushButton::clicked, this, &MainWindow::browseOutputPath);
     connect(ui->buildButton, &QPushButton::clicked, this, &MainWindow::buildProject);
     connect(ui->cleanButton, &QPushButton::clicked, this, &MainWindow::cleanBuild);
+    connect(ui->cancelButton, &QPushButton::clicked, this, &MainWindow::cancelBuild);
 
 //#ifdef Q_OS_WIN
    // ui->compilerPathInput->setText("clang++.exe");
@@ -87,9 +351,29 @@ MainWindow::~MainWindow()
 
 void MainWindow::appendLog(const QString &s)
 {
-    ui->outputBox->moveCursor(QTextCursor::End);
-    ui->outputBox->insertPlainText(s);
-    ui->outputBox->moveCursor(QTextCursor::End);
+    engine->logSink()->append(s);
+}
+
+void MainWindow::clearLog()
+{
+    engine->logSink()->clear();
+    ui->outputBox->clear();
+    diagnostics->clear();
+    remarks->clear();
+}
+
+// one batch from LogSink, follow the tail only if the user hasn't scrolled up
+void MainWindow::writeLogBatch(const QString &text)
+{
+    QScrollBar *bar = ui->outputBox->verticalScrollBar();
+    const bool atBottom = bar->value() >= bar->maximum() - 2;
+
+    QTextCursor c(ui->outputBox->document());
+    c.movePosition(QTextCursor::End);
+    c.insertText(text);
+
+    if (atBottom)
+        bar->setValue(bar->maximum());
 }
 
 QStringList MainWindow::parseLines(const QString &text) const
@@ -103,44 +387,6 @@ QStringList MainWindow::parseLines(const QString &text) const
     return lines;
 }
 
-QString MainWindow::compilerCmd() const
-{
-    QString cmd = ui->compilerPathInput->text().trimmed();
-#ifdef Q_OS_MAC
-    if (cmd.isEmpty())
-        cmd = "/usr/bin/clang++";
-#elif defined(Q_OS_WIN)
-    if (cmd.isEmpty())
-        cmd = "clang++.exe";
-#else
-    if (cmd.isEmpty())
-        cmd = "clang++";
-#endif
-    return cmd;
-}
-
-// MS Windows: .exe; macOS/Linux(Unix): **no extension** (strip .out if typed)
-QString MainWindow::targetPathWithExt(QString out) const
-{
-#ifdef Q_OS_WIN
-    if (!out.endsWith(".exe", Qt::CaseInsensitive))
-        out += ".exe";
-#else
-    if (out.endsWith(".out", Qt::CaseInsensitive))
-        out.chop(4);
-#endif
-    return out;
-}
-
-QString MainWindow::buildDirForTarget(const QString &target) const
-{
-    QFileInfo t(target);
-    QDir d = t.dir();
-    QString b = d.absoluteFilePath("build");
-    QDir().mkpath(b);
-    return b;
-}
-
 // file list actions
 void MainWindow::addFiles()
 {
@@ -149,21 +395,47 @@ void MainWindow::addFiles()
         "Add Source Files",
         QString(),
         "C/C++ Sources (*.cpp *.cc *.c);;Headers (*.h *.hpp);;All Files (*)");
-    for (const QString &f : files) {
-        if (f.isEmpty())
-            continue;
-        if (ui->fileList->findItems(f, Qt::MatchExactly).isEmpty())
-            ui->fileList->addItem(f);
-    }
+    sources->addFiles(files);
+}
+
+// a whole tree at once, narrowed down by globs (remembered for next time)
+void MainWindow::addFolder()
+{
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    const QString dir = QFileDialog::getExistingDirectory(
+        this, tr("Add Source Folder"), settings.value("importDir").toString());
+    if (dir.isEmpty())
+        return;
+    bool ok = false;
+    const QString include = QInputDialog::getText(
+        this, tr("Add Source Folder"), tr("Include files matching (space separated):"),
+        QLineEdit::Normal, settings.value("importInclude", "*.cpp *.cc *.c").toString(), &ok);
+    if (!ok)
+        return;
+    const QString exclude = QInputDialog::getText(
+        this, tr("Add Source Folder"),
+        tr("Skip files and folders matching (** crosses folders, a / matches the path):"),
+        QLineEdit::Normal, settings.value("importExclude", "build* test* third_party").toString(),
+        &ok);
+    if (!ok)
+        return;
+    settings.setValue("importDir", dir);
+    settings.setValue("importInclude", include);
+    settings.setValue("importExclude", exclude);
+
+    const QStringList found = lmc_findSources(dir, include.split(' ', Qt::SkipEmptyParts),
+                                              exclude.split(' ', Qt::SkipEmptyParts));
+    const int added = sources->addFiles(found);
+    statusBar()->showMessage(tr("%1 file(s) found, %2 added").arg(found.size()).arg(added));
 }
 
 void MainWindow::removeSelectedFiles()
 {
-    qDeleteAll(ui->fileList->selectedItems());
+    sources->removeFiles(ui->fileList->selectionModel()->selectedRows());
 }
 void MainWindow::clearFiles()
 {
-    ui->fileList->clear();
+    sources->clear();
 }
 
 void MainWindow::browseCompiler()
@@ -229,425 +501,448 @@ void MainWindow::browseOutputPath()
         ui->outputPathInput->setText(f);
 }
 
-// process run (handles stdout + stderr)
-bool MainWindow::runProcess(const QString &program,
-const QStringList &args,
-QString *stdoutOut,
-QString *stderrOut)
+// project <-> window fields
+LmcBuildConfig MainWindow::currentConfig() const
 {
-    QProcess p;
-    p.setProgram(program);
-    p.setArguments(args);
-    p.setProcessChannelMode(QProcess::SeparateChannels);
-
-    p.start();
-    if (!p.waitForStarted()) {
-        appendLog("\n❌ Failed to start: " + program + "\n");
-        return false;
+    LmcBuildConfig config;
+    config.files = sources->files();
+    config.compiler = ui->compilerPathInput->text().trimmed();
+    config.output = ui->outputPathInput->text().trimmed();
+    config.standard = ui->stdCombo->currentText();
+    config.profile = profile;
+    // saved along, so the project still builds where this profile isn't set up
+    const QVector<LmcProfile> profiles = lmc_loadProfiles();
+    const int profileIndex = lmc_findProfile(profiles, profile);
+    if (profileIndex >= 0) {
+        config.profileCxxflags = profiles.at(profileIndex).cxxflags;
+        config.profileLdflags = profiles.at(profileIndex).ldflags;
     }
+    config.cxxflags = parseLines(ui->cxxFlagsEdit->toPlainText());
+    config.includeDirs = parseLines(ui->includeDirsEdit->toPlainText());
+    config.defines = parseLines(ui->definesEdit->toPlainText());
+    config.ldflags = parseLines(ui->ldFlagsEdit->toPlainText());
+    config.libs = parseLines(ui->libsEdit->toPlainText());
+    config.jobs = ui->jobsSpin->value();
+    config.pch = usePch;
+    config.unity = useUnity;
+    config.unityBatch = unityBatch;
+    config.timeTrace = timeTraceAct->isChecked();
+    config.optRemarks = optRemarksAct->isChecked();
+    if (const QAction *a = linkerGroup->checkedAction())
+        config.linker = a->data().toString();
+    config.splitDwarf = splitDwarfAct->isChecked();
+    config.gdbIndex = gdbIndexAct->isChecked();
+    config.compressDebug = compressDebugAct->isChecked();
+    config.thinLto = thinLtoAct->isChecked();
+    config.pgoRuns = pgoRuns;
+    return config;
+}
 
-    while (p.state() != QProcess::NotRunning) {
-        p.waitForReadyRead(50);
-        const QByteArray outData = p.readAllStandardOutput();
-        const QByteArray errData = p.readAllStandardError();
-        if (!outData.isEmpty())
-            appendLog(QString::fromLocal8Bit(outData));
-        if (!errData.isEmpty())
-            appendLog(QString::fromLocal8Bit(errData));
+void MainWindow::applyConfig(const LmcBuildConfig &config)
+{
+    sources->setFiles(config.files);
+    if (!config.compiler.isEmpty())
+        ui->compilerPathInput->setText(config.compiler);
+    ui->outputPathInput->setText(config.output);
+    const int stdIndex = ui->stdCombo->findText(config.standard);
+    if (stdIndex >= 0)
+        ui->stdCombo->setCurrentIndex(stdIndex);
+    // a project from another machine brings its profile along, keep a local copy of it
+    if (!config.profile.isEmpty()
+        && (!config.profileCxxflags.isEmpty() || !config.profileLdflags.isEmpty())) {
+        QVector<LmcProfile> profiles = lmc_loadProfiles();
+        if (lmc_findProfile(profiles, config.profile) < 0) {
+            profiles << LmcProfile{config.profile, config.profileCxxflags, config.profileLdflags};
+            lmc_saveProfiles(profiles);
+        }
     }
+    setProfile(config.profile);
+    ui->cxxFlagsEdit->setPlainText(config.cxxflags.join('\n'));
+    ui->includeDirsEdit->setPlainText(config.includeDirs.join('\n'));
+    ui->definesEdit->setPlainText(config.defines.join('\n'));
+    ui->ldFlagsEdit->setPlainText(config.ldflags.join('\n'));
+    ui->libsEdit->setPlainText(config.libs.join('\n'));
+    pchAct->setChecked(config.pch);
+    unityAct->setChecked(config.unity);
+    unityBatch = config.unityBatch;
+    timeTraceAct->setChecked(config.timeTrace);
+    optRemarksAct->setChecked(config.optRemarks);
+    const QString linker = config.linker.isEmpty() ? QString("default") : config.linker;
+    const QList<QAction *> linkers = linkerGroup->actions();
+    for (QAction *a : linkers)
+        a->setChecked(a->data().toString() == linker);
+    splitDwarfAct->setChecked(config.splitDwarf);
+    gdbIndexAct->setChecked(config.gdbIndex);
+    compressDebugAct->setChecked(config.compressDebug);
+    thinLtoAct->setChecked(config.thinLto);
+    pgoRuns = config.pgoRuns;
+}
 
-    // drains
-    const QByteArray outData = p.readAllStandardOutput();
-    const QByteArray errData = p.readAllStandardError();
-    if (!outData.isEmpty())
-        appendLog(QString::fromLocal8Bit(outData));
-    if (!errData.isEmpty())
-        appendLog(QString::fromLocal8Bit(errData));
-
-    if (stdoutOut)
-        *stdoutOut = QString::fromLocal8Bit(outData);
-    if (stderrOut)
-        *stderrOut = QString::fromLocal8Bit(errData);
-
-    if (p.exitStatus() != QProcess::NormalExit || p.exitCode() != 0) {
-        appendLog("\nExited with code " + QString::number(p.exitCode()) + "\n");
-        return false;
+void MainWindow::fillProfileMenu()
+{
+    qDeleteAll(profileMenu->findChildren<QActionGroup *>());
+    profileMenu->clear();
+
+    auto *group = new QActionGroup(profileMenu);
+    QStringList names{QString()};
+    for (const LmcProfile &p : lmc_loadProfiles())
+        names << p.name;
+    for (const QString &name : std::as_const(names)) {
+        QAction *a = profileMenu->addAction(name.isEmpty() ? tr("None (flag boxes only)") : name);
+        a->setCheckable(true);
+        a->setChecked(name.compare(profile, Qt::CaseInsensitive) == 0);
+        group->addAction(a);
+        connect(a, &QAction::triggered, this, [this, name] { setProfile(name); });
     }
-    return true;
+
+    profileMenu->addSeparator();
+    connect(profileMenu->addAction(tr("New Profile…")), &QAction::triggered, this,
+            &MainWindow::newProfile);
+    QAction *editAct = profileMenu->addAction(tr("Edit Profile Flags…"));
+    editAct->setEnabled(!profile.isEmpty());
+    connect(editAct, &QAction::triggered, this, &MainWindow::editProfile);
+    QAction *deleteAct = profileMenu->addAction(tr("Delete Profile"));
+    deleteAct->setEnabled(!profile.isEmpty());
+    connect(deleteAct, &QAction::triggered, this, &MainWindow::deleteProfile);
 }
 
-// auto-detect helpers (SDL2, GLFW, SFML)
-static bool lmc_containsSwitch(const QStringList &xs, const QString &needlePrefix)
+void MainWindow::setProfile(const QString &name)
 {
-    for (const QString &x : xs)
-        if (x.startsWith(needlePrefix))
-            return true;
-    return false;
+    profile = name;
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    settings.setValue("profile", profile);
+    // usually called from one of the menu's own actions, rebuild once it's done with them
+    QMetaObject::invokeMethod(this, &MainWindow::fillProfileMenu, Qt::QueuedConnection);
 }
 
-static QStringList lmc_splitArgs(const QString &s)
+// a new profile starts as a copy of the active one
+void MainWindow::newProfile()
 {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-    return QProcess::splitCommand(s);
-#else
-    return s.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-#endif
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("New Profile"), tr("Profile name:"),
+                                               QLineEdit::Normal, QString(), &ok)
+                             .trimmed();
+    if (!ok || name.isEmpty())
+        return;
+    QVector<LmcProfile> profiles = lmc_loadProfiles();
+    if (lmc_findProfile(profiles, name) >= 0) {
+        QMessageBox::warning(this, tr("New Profile"),
+                             tr("There already is a profile called %1.").arg(name));
+        return;
+    }
+
+    LmcProfile p;
+    const int current = lmc_findProfile(profiles, profile);
+    if (current >= 0)
+        p = profiles.at(current);
+    p.name = name;
+    profiles << p;
+    lmc_saveProfiles(profiles);
+    profile = name;
+    editProfile();
+    setProfile(name);
 }
 
-static QString lmc_runShell(const QString &cmd)
+void MainWindow::editProfile()
 {
-#ifdef Q_OS_WIN
-    Q_UNUSED(cmd)
-    return QString();
-#else
-    QProcess sh;
-    sh.start("/bin/sh", {"-c", cmd});
-    sh.waitForFinished(-1);
-    return QString::fromLocal8Bit(sh.readAllStandardOutput()).trimmed();
-#endif
+    QVector<LmcProfile> profiles = lmc_loadProfiles();
+    const int index = lmc_findProfile(profiles, profile);
+    if (index < 0)
+        return;
+    LmcProfile &p = profiles[index];
+
+    bool ok = false;
+    const QString cxx = QInputDialog::getMultiLineText(
+        this, tr("Profile %1").arg(p.name),
+        tr("C++ flags, one per line (the C++ flags box still applies on top):"),
+        p.cxxflags.join('\n'), &ok);
+    if (!ok)
+        return;
+    const QString ld = QInputDialog::getMultiLineText(
+        this, tr("Profile %1").arg(p.name),
+        tr("Linker flags, one per line (the linker flags box still applies on top):"),
+        p.ldflags.join('\n'), &ok);
+    if (!ok)
+        return;
+    p.cxxflags = parseLines(cxx);
+    p.ldflags = parseLines(ld);
+    lmc_saveProfiles(profiles);
 }
 
-// pkg-config: returns {cflags, libs}
-static QPair<QStringList, QStringList> lmc_pkgConfigFlags(const QString &pkg)
+// objects built under the profile stay in build/profiles/ until the next Clean
+void MainWindow::deleteProfile()
 {
-    QStringList cflags, libs;
-#ifndef Q_OS_WIN
-    const QString c = lmc_runShell("pkg-config --cflags " + pkg);
-    const QString l = lmc_runShell("pkg-config --libs " + pkg);
-    if (!c.isEmpty())
-        cflags = lmc_splitArgs(c);
-    if (!l.isEmpty())
-        libs = lmc_splitArgs(l);
-#endif
-    return {cflags, libs};
+    QVector<LmcProfile> profiles = lmc_loadProfiles();
+    const int index = lmc_findProfile(profiles, profile);
+    if (index < 0)
+        return;
+    if (QMessageBox::question(this, tr("Delete Profile"),
+                              tr("Delete the profile %1?").arg(profiles.at(index).name))
+        != QMessageBox::Yes)
+        return;
+    profiles.removeAt(index);
+    lmc_saveProfiles(profiles);
+    setProfile(QString());
 }
 
-// sdl2-config
-static QPair<QStringList, QStringList> lmc_sdl2ConfigFlags()
+void MainWindow::openProject()
 {
-#ifndef Q_OS_WIN
-    QStringList c, l;
-    const QString cstr = lmc_runShell("sdl2-config --cflags");
-    const QString lstr = lmc_runShell("sdl2-config --libs");
-    if (!cstr.isEmpty())
-        c = lmc_splitArgs(cstr);
-    if (!lstr.isEmpty())
-        l = lmc_splitArgs(lstr);
-    return {c, l};
-#else
-    return {};
-#endif
+    const QString f = QFileDialog::getOpenFileName(this,
+                                                   "Open Project",
+                                                   QString(),
+                                                   "LazyMansClang Project (*.lmcproj);;All Files (*)");
+    if (f.isEmpty())
+        return;
+    LmcBuildConfig config = currentConfig();
+    QString error;
+    if (!config.load(f, &error)) {
+        QMessageBox::warning(this, "Open Project", "Could not read " + f + ":\n" + error);
+        return;
+    }
+    applyConfig(config);
 }
 
-static void lmc_addIfMissing(QStringList &dest, const QStringList &src)
+void MainWindow::saveProject()
 {
-    for (const QString &s : src)
-        if (!dest.contains(s))
-            dest << s;
+    const QString f = QFileDialog::getSaveFileName(this,
+                                                   "Save Project",
+                                                   QString(),
+                                                   "LazyMansClang Project (*.lmcproj)");
+    if (f.isEmpty())
+        return;
+    if (!currentConfig().save(f))
+        QMessageBox::warning(this, "Save Project", "Could not write " + f);
 }
 
-struct LmcAutoNeed
+// build | clean
+void MainWindow::cancelBuild()
 {
-    bool sdl = false, sdl_ttf = false, sdl_image = false, glfw = false, sfml = false;
-};
+    if (benchmark->isRunning())
+        benchmark->cancel();
+    else if (pgo->isRunning())
+        pgo->cancel();
+    else
+        engine->cancel();
+}
 
-static LmcAutoNeed lmc_scanIncludesForNeeds(const QStringList &sources)
+void MainWindow::setBuildRunning(bool running)
 {
-    LmcAutoNeed n;
-    for (const QString &path : sources) {
-        QFile f(path);
-        if (!f.open(QIODevice::ReadOnly))
-            continue;
-        const QString text = QString::fromUtf8(f.readAll());
-        if (text.contains("#include <SDL2/") || text.contains("#include <SDL.h>"))
-            n.sdl = true;
-        if (text.contains("#include <SDL_ttf.h>")) {
-            n.sdl = true;
-            n.sdl_ttf = true;
-        }
-        if (text.contains("#include <SDL_image.h>")) {
-            n.sdl = true;
-            n.sdl_image = true;
-        }
-        if (text.contains("#include <GLFW/"))
-            n.glfw = true;
-        if (text.contains("#include <SFML/"))
-            n.sfml = true;
+    ui->buildButton->setEnabled(!running);
+    ui->cleanButton->setEnabled(!running);
+    ui->cancelButton->setEnabled(running);
+    if (!running) {
+        etaTimer->stop();
+        buildProgress->hide();
     }
-    return n;
 }
 
-static void lmc_addWindowsSDL2FromEnv(QStringList &incSwitches,
-            QStringList &ldflags,
-            QStringList &libs)
+void MainWindow::onBuildProgress(int done, int total, qint64 remainingMs)
 {
-#ifdef Q_OS_WIN
-    const QString sdl2dir = qEnvironmentVariable("SDL2_DIR");
-    if (!sdl2dir.isEmpty()) {
-        const QString inc = sdl2dir + "/include";
-        const QString lib = sdl2dir + "/lib";
-        if (!lmc_containsSwitch(incSwitches, "-I" + inc))
-            incSwitches << ("-I" + inc);
-        if (!ldflags.contains("-L" + lib))
-            ldflags << ("-L" + lib);
-        if (!libs.contains("-lSDL2"))
-            libs << "-lSDL2";
-        if (!libs.contains("-lSDL2main"))
-            libs << "-lSDL2main";
-    }
-#endif
+    buildProgress->setRange(0, qMax(1, total));
+    buildProgress->setValue(done);
+    buildProgress->show();
+    etaMs = remainingMs;
+    etaClock.start();
+    if (!etaTimer->isActive())
+        etaTimer->start();
+    showEta();
 }
 
-static void lmc_addMacBrewFallback(const QString &pkg,
-            QStringList &incSwitches,
-            QStringList &ldflags)
+void MainWindow::showEta()
 {
-#ifdef Q_OS_MAC
-    const QString prefix = lmc_runShell("brew --prefix " + pkg);
-    if (!prefix.isEmpty()) {
-        const QString inc = prefix + "/include";
-        const QString lib = prefix + "/lib";
-        if (!lmc_containsSwitch(incSwitches, "-I" + inc))
-            incSwitches << ("-I" + inc);
-        if (!ldflags.contains("-L" + lib))
-            ldflags << ("-L" + lib);
-    }
-#endif
+    const qint64 left = qMax<qint64>(0, etaMs - etaClock.elapsed()) / 1000;
+    QString eta;
+    if (left == 0)
+        eta = tr("almost done");
+    else if (left < 60)
+        eta = tr("~%1 s left").arg(left);
+    else
+        eta = tr("~%1 min %2 s left").arg(left / 60).arg(left % 60, 2, 10, QChar('0'));
+    buildProgress->setFormat(QString("%v/%m · ") + eta);
 }
 
-// build | clean
 void MainWindow::buildProject()
 {
-    ui->outputBox->clear();
-
-    QString out = ui->outputPathInput->text().trimmed();
-    if (out.isEmpty()) {
-        appendLog("❌ Please choose an output path.\n");
-        return;
-    }
-    out = targetPathWithExt(out);
-
-    // get src files
-    QStringList sources;
-    for (int i = 0; i < ui->fileList->count(); ++i) {
-        const QString path = ui->fileList->item(i)->text();
-        if (path.endsWith(".c", Qt::CaseInsensitive) || path.endsWith(".cc", Qt::CaseInsensitive)
-            || path.endsWith(".cpp", Qt::CaseInsensitive)) {
-            sources << path;
-        }
-    }
-    if (sources.isEmpty()) {
-        appendLog("❌ Add at least one source file.\n");
+    if (engine->isRunning() || benchmark->isRunning())
         return;
+    clearLog();
+    statusBar()->showMessage(tr("Building…"));
+    setBuildRunning(true);
+    // finished() can arrive before start() returns, onBuildFinished() handles both orders
+    if (!engine->start(currentConfig())) {
+        statusBar()->clearMessage();
+        setBuildRunning(false);
     }
+}
 
-    // check for multiple main() functions (mostly for me because i'm a doughnut)
-    QStringList mainFiles;
-    static const QRegularExpression kMainRegex(R"(\bint\s+main\s*\()");
-
-    for (int i = 0; i < sources.size(); ++i) {
-        const QString &src = sources.at(i);
-        QFile f(src);
-        if (f.open(QIODevice::ReadOnly)) {
-            const QString content = QString::fromUtf8(f.readAll());
-            if (kMainRegex.match(content).hasMatch()) {
-                mainFiles << QFileInfo(src).fileName();
-            }
-        }
+// instrumented build, the training runs asked for here, then the optimized build
+void MainWindow::buildWithProfile()
+{
+    if (engine->isRunning() || pgo->isRunning() || benchmark->isRunning())
+        return;
+    bool ok = false;
+    const QString runs = QInputDialog::getMultiLineText(
+        this, tr("Profile-Guided Build"),
+        tr("Training runs, one line of program arguments per run\n"
+           "(leave empty for a single run without arguments):"),
+        pgoRuns.join('\n'), &ok);
+    if (!ok)
+        return;
+    pgoRuns = parseLines(runs);
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    settings.setValue("pgoRuns", pgoRuns);
+
+    clearLog();
+    statusBar()->showMessage(tr("Profile-guided build…"));
+    setBuildRunning(true);
+    if (!pgo->start(currentConfig())) {
+        statusBar()->clearMessage();
+        setBuildRunning(false);
     }
+}
 
-    if (mainFiles.size() > 1) {
-        appendLog("⚠️ Multiple main() functions found:\n");
-        for (const QString &f : mainFiles)
-            appendLog("   - " + f + "\n");
-        appendLog("❌ Only one main() is allowed per program. Please deselect extra files.\n");
+void MainWindow::setWatching(bool on)
+{
+    rebuildPending = false;
+    if (!on) {
+        watcher->stop();
+        statusBar()->clearMessage();
         return;
     }
+    watcher->setPaths(sources->files()); // headers join after the first build
+    buildProject();
+}
 
-    // flags from front-end UI
-    auto parseBox = [&](QPlainTextEdit *box) {
-        QStringList L;
-        for (auto &line : box->toPlainText().split('\n')) {
-            auto t = line.trimmed();
-            if (!t.isEmpty())
-                L << t;
-        }
-        return L;
-    };
-    QStringList cxxLines = parseBox(ui->cxxFlagsEdit);
-    QStringList incLines = parseBox(ui->includeDirsEdit);
-    QStringList defLines = parseBox(ui->definesEdit);
-    QStringList ldLines = parseBox(ui->ldFlagsEdit);
-    QStringList libLines = parseBox(ui->libsEdit);
-
-    // split like shell, accept "VAR = ..." style
-    auto stripMakeVar = [](const QString &line) -> QString {
-        int eq = line.indexOf('=');
-        if (eq >= 0)
-            return line.mid(eq + 1).trimmed();
-        return line.trimmed();
-    };
-    auto linesToArgs = [&](const QStringList &lines) -> QStringList {
-        QStringList args;
-        for (const QString &ln : lines) {
-            const QString s = stripMakeVar(ln);
-            if (!s.isEmpty())
-                args << lmc_splitArgs(s);
-        }
-        return args;
-    };
-
-    QStringList cxxflags = linesToArgs(cxxLines);
-    QStringList incs = linesToArgs(incLines);
-    QStringList defs = linesToArgs(defLines);
-    QStringList ldflags = linesToArgs(ldLines);
-    QStringList libs = linesToArgs(libLines);
-
-    // normalize -I / -D for bare values
-    QStringList incSwitches;
-    for (auto &i : incs)
-        incSwitches << (i.startsWith("-I") ? i : "-I" + i);
-    QStringList defSwitches;
-    for (auto &d : defs)
-        defSwitches << (d.startsWith("-D") ? d : "-D" + d);
-
-    // C++ standard
-    const QString stdSel = ui->stdCombo->currentText();
-    if (stdSel.startsWith("c++"))
-        cxxflags << ("-std=" + stdSel);
-
-    // flag auto-detection logic
-    const LmcAutoNeed need = lmc_scanIncludesForNeeds(sources);
-
-    // sdl2 family
-    if (need.sdl) {
-        auto sdlCfg = lmc_sdl2ConfigFlags();
-        lmc_addIfMissing(cxxflags, sdlCfg.first);
-        lmc_addIfMissing(libs, sdlCfg.second);
-
-        auto sdlPkg = lmc_pkgConfigFlags("sdl2");
-        lmc_addIfMissing(cxxflags, sdlPkg.first);
-        lmc_addIfMissing(libs, sdlPkg.second);
-
-#ifdef Q_OS_MAC
-        if (!lmc_containsSwitch(cxxflags, "-I/opt/homebrew/include")
-            && !lmc_containsSwitch(cxxflags, "-I/usr/local/include")) {
-            lmc_addMacBrewFallback("sdl2", incSwitches, ldflags);
-            if (!lmc_containsSwitch(incSwitches, "-I/opt/homebrew/include"))
-                incSwitches << "-I/opt/homebrew/include";
-        }
-#endif
-        if (need.sdl_ttf) {
-            auto ttfPkg = lmc_pkgConfigFlags("SDL2_ttf");
-            lmc_addIfMissing(cxxflags, ttfPkg.first);
-            lmc_addIfMissing(libs, ttfPkg.second);
-            if (!libs.contains("-lSDL2_ttf"))
-                libs << "-lSDL2_ttf";
-#ifdef Q_OS_MAC
-            lmc_addMacBrewFallback("sdl2_ttf", incSwitches, ldflags);
-#endif
-        }
-        if (need.sdl_image) {
-            auto imgPkg = lmc_pkgConfigFlags("SDL2_image");
-            lmc_addIfMissing(cxxflags, imgPkg.first);
-            lmc_addIfMissing(libs, imgPkg.second);
-            if (!libs.contains("-lSDL2_image"))
-                libs << "-lSDL2_image";
-#ifdef Q_OS_MAC
-            lmc_addMacBrewFallback("sdl2_image", incSwitches, ldflags);
-#endif
-        }
-
-        lmc_addWindowsSDL2FromEnv(incSwitches, ldflags, libs);
-
-        // ensure link when flimsy auto-detect can't find pkg-config/sdl2-config
-#ifdef Q_OS_MAC
-        if (!ldflags.contains("-L/opt/homebrew/lib"))
-            ldflags << "-L/opt/homebrew/lib";
-#endif
-        if (!libs.contains("-lSDL2"))
-            libs << "-lSDL2";
-    }
+void MainWindow::onWatchedFilesChanged(const QStringList &files)
+{
+    QStringList names;
+    for (const QString &f : files)
+        names << QFileInfo(f).fileName();
+    statusBar()->showMessage(tr("Changed: %1").arg(names.join(", ")));
 
-    // GLFW
-    if (need.glfw) {
-        auto P = lmc_pkgConfigFlags("glfw3");
-        lmc_addIfMissing(cxxflags, P.first);
-        lmc_addIfMissing(libs, P.second);
-#ifdef Q_OS_MAC
-        lmc_addMacBrewFallback("glfw", incSwitches, ldflags);
-#endif
-        if (!libs.contains("-lglfw"))
-            libs << "-lglfw";
+    if (pgo->isRunning())
+        return;
+    // only the newest state is worth compiling, onBuildFinished() starts the next one
+    if (engine->isRunning()) {
+        rebuildPending = true;
+        engine->cancel();
+        return;
     }
+    buildProject();
+}
 
-    // SFML
-    if (need.sfml) {
-        QStringList sfmlPkgs = {"sfml-graphics", "sfml-window", "sfml-system", "sfml-audio"};
-        for (const QString &pkg : sfmlPkgs) {
-            auto P = lmc_pkgConfigFlags(pkg);
-            lmc_addIfMissing(cxxflags, P.first);
-            lmc_addIfMissing(libs, P.second);
+void MainWindow::onBuildFinished(bool ok, const QString &out)
+{
+    // the instrumented and optimized builds of a PGO run, PgoWorkflow::finished comes later
+    if (pgo->isRunning())
+        return;
+    setBuildRunning(false);
+    statusBar()->showMessage(engine->timingSummary());
+    const bool bench = benchNext;
+    benchNext = false;
+
+    // watch mode: follow whatever the build read, never launch the app on every save
+    if (watchAct->isChecked()) {
+        watcher->setPaths(engine->inputFiles());
+        if (rebuildPending) {
+            rebuildPending = false;
+            // the engine is still winding down this build when finished() arrives
+            QMetaObject::invokeMethod(this, &MainWindow::buildProject, Qt::QueuedConnection);
         }
-#ifdef Q_OS_MAC
-        lmc_addMacBrewFallback("sfml", incSwitches, ldflags);
-#endif
+        return;
     }
-
-    // compiler path
-    QString compiler = compilerCmd();
-
-    // Build one final command: clang++ srcs -o out [flags]
-    QStringList args;
-    args << sources << "-o" << out;
-    args << cxxflags << incSwitches << defSwitches << ldflags << libs;
-
-    appendLog("Command: " + compiler + " " + args.join(" ") + "\n");
-
-    if (!runProcess(compiler, args)) {
-        appendLog("❌ Build failed.\n");
+    if (!ok)
+        return;
+    if (bench) {
+        startBenchmark(out);
         return;
     }
 
-#if defined(Q_OS_UNIX) && !defined(Q_OS_WIN)
-    QFile::setPermissions(out, QFile::permissions(out) | QFileDevice::ExeUser);
-#endif
-
     // launch raw.executable (macOS/Linux: plain exec; MS Windows: .exe)
     {
-        QFileInfo outputInfo(out);
         appendLog("Launching app...\n");
-        if (!QProcess::startDetached("/usr/bin/open",
-            {"-a", "Terminal", out},
-            QFileInfo(out).absolutePath())) {
+        if (!lmc_launchInTerminal(out))
             appendLog("⚠️ Could not launch automatically. Run manually: " + out + "\n");
-        }
     }
-
-    appendLog("✅ Build succeeded. Output: " + out + "\n");
 }
 
-void MainWindow::cleanBuild()
+void MainWindow::buildAndBenchmark()
 {
-    ui->outputBox->clear();
+    if (engine->isRunning() || pgo->isRunning() || benchmark->isRunning())
+        return;
+    benchNext = true;
+    buildProject();
+    if (!engine->isRunning() && !benchmark->isRunning())
+        benchNext = false; // nothing started, or it finished and benchmarked already
+}
 
-    QString out = ui->outputPathInput->text().trimmed();
-    if (out.isEmpty()) {
-        appendLog("ℹ️ Nothing to clean (no target set).\n");
+void MainWindow::benchmarkSettings()
+{
+    bool ok = false;
+    const int runs = QInputDialog::getInt(this, tr("Benchmark Settings"),
+                                          tr("Timed runs:"), benchRuns, 1, 10000, 1, &ok);
+    if (!ok)
         return;
-    }
+    const int warmup = QInputDialog::getInt(this, tr("Benchmark Settings"),
+                                            tr("Warmup runs (not timed):"), benchWarmup, 0, 1000,
+                                            1, &ok);
+    if (!ok)
+        return;
+    const QString args = QInputDialog::getText(this, tr("Benchmark Settings"),
+                                               tr("Program arguments for every run:"),
+                                               QLineEdit::Normal, benchArgs, &ok);
+    if (!ok)
+        return;
+    benchRuns = runs;
+    benchWarmup = warmup;
+    benchArgs = args;
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    settings.setValue("benchRuns", runs);
+    settings.setValue("benchWarmup", warmup);
+    settings.setValue("benchArgs", args);
+}
 
-    // normalize same ruleset as build (no .out on macOS/Linux(Unix))
-    out = targetPathWithExt(out);
+void MainWindow::startBenchmark(const QString &target)
+{
+    benchTarget = target;
+    benchProfile = profile;
+    appendLog(QString("Benchmark: %1 run(s) of %2 after %3 warmup\n")
+                  .arg(benchRuns)
+                  .arg(QFileInfo(target).fileName())
+                  .arg(benchWarmup));
+    if (!benchmark->start(target, lmc_splitArgs(benchArgs), benchWarmup, benchRuns))
+        return;
+    setBuildRunning(true);
+    statusBar()->showMessage(tr("Benchmarking…"));
+}
 
-    if (QFile::exists(out)) {
-        if (QFile::remove(out))
-            appendLog("Removed: " + out + "\n");
-        else
-            appendLog("⚠️ Could not remove: " + out + "\n");
-    } else {
-        appendLog("ℹ️ No file at: " + out + "\n");
+// stats, then how they compare with the last benchmark of the same profile
+void MainWindow::onBenchmarkFinished(bool ok)
+{
+    setBuildRunning(false);
+    statusBar()->clearMessage();
+    if (!ok) {
+        appendLog("❌ Benchmark failed, " + benchmark->error() + "\n");
+        engine->logSink()->flush();
+        return;
     }
+    LmcRunRecord record;
+    record.when = QDateTime::currentDateTimeUtc();
+    record.profile = benchProfile;
+    record.flags = engine->buildFlags();
+    record.binary = lmc_binaryStamp(benchTarget);
+    record.args = lmc_splitArgs(benchArgs);
+    record.stats = benchmark->stats();
+    const QString history = lmc_runHistoryPath(BuildEngine::buildDirForTarget(benchTarget));
+    appendLog(lmc_formatRunStats(record.stats) + lmc_fileRun(history, record));
+    engine->logSink()->flush();
+    statusBar()->showMessage(tr("%1 ms mean over %2 run(s)")
+                                 .arg(record.stats.meanMs, 0, 'f', 2)
+                                 .arg(record.stats.runs));
+}
 
-    appendLog("Clean complete! \n");
+void MainWindow::cleanBuild()
+{
+    clearLog();
+    engine->clean(currentConfig());
 }
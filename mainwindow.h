@@ -1,5 +1,6 @@
 // (c) 2025 Stardust Softworks
 #pragma once
+#include <QElapsedTimer>
 #include <QFutureWatcher>
 #include <QMainWindow>
 #include <QProcess>
@@ -11,6 +12,21 @@ class MainWindow;
 }
 QT_END_NAMESPACE
 
+class BuildEngine;
+class BuildWatcher;
+class DiagnosticsView;
+class PgoWorkflow;
+class QAction;
+class QActionGroup;
+class QDockWidget;
+class QMenu;
+class QProgressBar;
+class QTimer;
+class RemarksView;
+class SourceListModel;
+class RunBenchmark;
+struct LmcBuildConfig;
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -20,26 +36,86 @@ public:
 
 private slots:
     void addFiles();
+    void addFolder();
     void removeSelectedFiles();
     void clearFiles();
     void browseCompiler();
     void browseOutputPath();
     void checkCompilerArchitecture(const QString &compilerPath);
 
+    void openProject();
+    void saveProject();
+
     void buildProject();
+    void buildWithProfile();
+    void buildAndBenchmark();
+    void benchmarkSettings();
+    void newProfile();
+    void editProfile();
+    void deleteProfile();
+    void cancelBuild();
     void cleanBuild();
 
 private:
     Ui::MainWindow *ui;
+    BuildEngine *engine{};
+    SourceListModel *sources{}; // behind ui->fileList
+    PgoWorkflow *pgo{};
+    DiagnosticsView *diagnostics{};
+    QDockWidget *diagnosticsDock{};
+    RemarksView *remarks{};
+    QDockWidget *remarksDock{};
+    QProgressBar *buildProgress{}; // in the status bar while compiling
+    QTimer *etaTimer{};            // counts the ETA down between compiles
+    QElapsedTimer etaClock;        // since the engine's last estimate
+    qint64 etaMs = 0;
+    QMenu *profileMenu{};
+    BuildWatcher *watcher{};
+    QAction *watchAct{};
+    bool rebuildPending = false; // a change arrived mid-build, that build gets cancelled
+    QString profile; // active build profile, empty: the flag boxes alone
+    QAction *pchAct{};
+    QAction *unityAct{};
+    bool usePch = false;
+    bool useUnity = false;
+    int unityBatch = 0; // sources per unity batch, 0 = automatic
+    QAction *timeTraceAct{};
+    QAction *optRemarksAct{};
+    QActionGroup *linkerGroup{}; // each action's data() is the "linker" setting
+    QAction *splitDwarfAct{};
+    QAction *gdbIndexAct{};
+    QAction *compressDebugAct{};
+    QAction *thinLtoAct{};
+    QStringList pgoRuns; // training run arguments, one line per run
+    RunBenchmark *benchmark{};
+    bool benchNext = false; // the build in flight ends in a benchmark, not a launch
+    int benchRuns = 10;
+    int benchWarmup = 2;
+    QString benchArgs;
+    QString benchTarget;  // of the benchmark in flight
+    QString benchProfile;
 
-    QString compilerCmd() const;              // resolve compiler path
-    QString targetPathWithExt(QString) const; // add .exe/.out when missing
-    QString buildDirForTarget(const QString &target) const;
+    LmcBuildConfig currentConfig() const;
+    void applyConfig(const LmcBuildConfig &config);
 
     QStringList parseLines(const QString &text) const; // split by lines, trim, drop empties
-    void appendLog(const QString &s);
-    bool runProcess(const QString &program,
-                    const QStringList &args,
-                    QString *stdoutOut = nullptr,
-                    QString *stderrOut = nullptr);
+    void appendLog(const QString &s); // batched through the engine's LogSink
+    void clearLog(); // and the diagnostics/remarks panels
+    void writeLogBatch(const QString &text);
+
+    // the pipeline itself lives in BuildEngine, the window only reacts to its end
+    void onBuildFinished(bool ok, const QString &out);
+    void setBuildRunning(bool running);
+    void onBuildProgress(int done, int total, qint64 remainingMs);
+    void showEta();
+
+    // rebuilt from QSettings whenever the profile list or the selection changes
+    void fillProfileMenu();
+    void setProfile(const QString &name);
+
+    void setWatching(bool on);
+
+    void startBenchmark(const QString &target);
+    void onBenchmarkFinished(bool ok);
+    void onWatchedFilesChanged(const QStringList &files);
 };
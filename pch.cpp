@@ -0,0 +1,54 @@
+// (c) 2025 Stardust Softworks
+#include "pch.h"
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+
+QStringList lmc_pickPchHeaders(const QVector<LmcSourceInfo> &infos)
+{
+    QStringList order;
+    QHash<QString, int> users;
+    for (const LmcSourceInfo &info : infos) {
+        QSet<QString> seen; // a header included twice by one file counts once
+        for (const QString &inc : info.systemIncludes) {
+            if (seen.contains(inc))
+                continue;
+            seen.insert(inc);
+            if (!users.contains(inc))
+                order << inc;
+            ++users[inc];
+        }
+    }
+
+    const int need = (int(infos.size()) + 1) / 2;
+    QStringList picked;
+    for (const QString &inc : std::as_const(order))
+        if (users.value(inc) >= need)
+            picked << inc;
+    return picked;
+}
+
+LmcTuFiles lmc_writePchHeader(const QString &buildDir, const QStringList &headers)
+{
+    const QDir dir(buildDir);
+    const LmcTuFiles tu = lmc_tuFiles(dir.absoluteFilePath("lmc_pch.hpp"),
+                                      dir.absoluteFilePath("lmc_pch.hpp.pch"));
+
+    QByteArray text = "// generated by LazyMansClang, rebuilt when the shared headers change\n";
+    for (const QString &h : headers)
+        text += "#include <" + h.toUtf8() + ">\n";
+
+    QFile current(tu.src);
+    if (current.open(QIODevice::ReadOnly) && current.readAll() == text)
+        return tu;
+    current.close();
+
+    QSaveFile f(tu.src);
+    if (f.open(QIODevice::WriteOnly)) {
+        f.write(text);
+        f.commit();
+    }
+    return tu;
+}
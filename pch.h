@@ -0,0 +1,15 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QStringList>
+#include <QVector>
+#include "incremental.h"
+#include "sourcescan.h"
+
+// <...> headers worth precompiling: included straight from at least half of the
+// sources, in the order they first show up
+QStringList lmc_pickPchHeaders(const QVector<LmcSourceInfo> &infos);
+
+// build/lmc_pch.hpp including those headers, compiled to build/lmc_pch.hpp.pch.
+// the header is only rewritten when the list changes, so its mtime (and the
+// .pch depending on it) survives unchanged builds.
+LmcTuFiles lmc_writePchHeader(const QString &buildDir, const QStringList &headers);
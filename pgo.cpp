@@ -0,0 +1,291 @@
+// (c) 2025 Stardust Softworks
+#include "pgo.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include "jobrunner.h"
+#include "logsink.h"
+
+PgoWorkflow::PgoWorkflow(BuildEngine *engine, QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_runner(new JobRunner(this))
+{
+    // queued: the engine closes build.log right after finished(), the stale-profile check reads it
+    connect(m_engine, &BuildEngine::finished, this, &PgoWorkflow::onBuildFinished,
+            Qt::QueuedConnection);
+
+    connect(m_runner, &JobRunner::jobStarted, this, [this](int index) {
+        if (m_step == Train) {
+            const LmcJob &job = m_runner->jobs().at(index);
+            log("▶ " + job.label + ": " + QFileInfo(job.program).fileName() + " "
+                + job.args.join(" ") + "\n");
+        }
+    });
+    connect(m_runner, &JobRunner::jobOutput, this, [this](int, const QString &chunk) {
+        log(chunk);
+    });
+    connect(m_runner, &JobRunner::jobFinished, this,
+            [this](int index, bool ok, const QString &output) {
+        if (m_step != Train) {
+            m_output = output;
+            return;
+        }
+        if (!ok)
+            log("⚠️ " + m_runner->jobs().at(index).label
+                + " failed, its profile may be missing or partial\n");
+    });
+    connect(m_runner, &JobRunner::allFinished, this, &PgoWorkflow::onJobsFinished);
+}
+
+QStringList PgoWorkflow::profdataCommand(const QString &compiler)
+{
+    QString compilerPath = compiler;
+    if (!QFileInfo(compiler).isAbsolute())
+        compilerPath = QStandardPaths::findExecutable(compiler);
+    const QStringList nextToCompiler{QFileInfo(compilerPath).absolutePath()};
+
+    // clang++-18 comes with llvm-profdata-18 on Debian and friends
+    QStringList names{"llvm-profdata"};
+    const QRegularExpressionMatch version
+        = QRegularExpression("-(\\d+)(\\.exe)?$").match(QFileInfo(compiler).fileName());
+    if (version.hasMatch())
+        names.prepend("llvm-profdata-" + version.captured(1));
+
+    for (const QString &name : std::as_const(names)) {
+        QString path;
+        if (!compilerPath.isEmpty())
+            path = QStandardPaths::findExecutable(name, nextToCompiler);
+        if (path.isEmpty())
+            path = QStandardPaths::findExecutable(name);
+        if (!path.isEmpty())
+            return {path};
+    }
+#ifdef Q_OS_MAC
+    // Apple's clang keeps it inside the toolchain
+    return {"/usr/bin/xcrun", "llvm-profdata"};
+#else
+    return {};
+#endif
+}
+
+bool PgoWorkflow::start(const LmcBuildConfig &config)
+{
+    if (m_step != Idle || m_engine->isRunning())
+        return false;
+    m_config = config;
+    m_exitCode = 1;
+    m_cancelled = false;
+    m_target.clear();
+
+    QString compiler = config.compiler.trimmed();
+    if (compiler.isEmpty())
+        compiler = BuildEngine::defaultCompiler();
+    m_profdata = profdataCommand(compiler);
+    if (m_profdata.isEmpty()) {
+        log("❌ PGO needs llvm-profdata, it isn't next to " + compiler + " or on PATH.\n");
+        m_engine->logSink()->flush();
+        return false;
+    }
+
+    log("PGO 1/4: instrumented build\n");
+    LmcBuildConfig instrumented = config;
+    instrumented.profileGenerate = true;
+    instrumented.profileUse.clear();
+    m_step = Instrument;
+    if (!m_engine->start(instrumented)) {
+        m_step = Idle;
+        m_exitCode = m_engine->exitCode();
+        return false;
+    }
+    return true;
+}
+
+void PgoWorkflow::cancel()
+{
+    if (m_step == Idle)
+        return;
+    m_cancelled = true;
+    if (m_runner->isRunning())
+        m_runner->cancel();
+    else if (m_engine->isRunning())
+        m_engine->cancel();
+}
+
+void PgoWorkflow::onBuildFinished(bool ok, const QString &target)
+{
+    if (m_step == Instrument) {
+        if (!ok) {
+            m_exitCode = m_engine->exitCode();
+            done(false);
+            return;
+        }
+        m_target = target;
+        m_dir = QDir(BuildEngine::buildDirForTarget(target)).absoluteFilePath("pgo");
+        startTraining();
+    } else if (m_step == Optimize) {
+        m_exitCode = m_engine->exitCode();
+        if (ok)
+            reportStaleProfile();
+        done(ok);
+    }
+}
+
+// every run writes its own .profraw (%p = pid), a crashed run just leaves none
+void PgoWorkflow::startTraining()
+{
+    QDir dir(m_dir);
+    dir.mkpath(".");
+    const QStringList stale = dir.entryList({"*.profraw"}, QDir::Files);
+    for (const QString &f : stale)
+        dir.remove(f);
+
+    QStringList runs = m_config.pgoRuns;
+    if (runs.isEmpty())
+        runs << QString();
+
+    QVector<LmcJob> jobs;
+    for (int i = 0; i < runs.size(); ++i) {
+        LmcJob job;
+        job.label = QString("training run %1/%2").arg(i + 1).arg(runs.size());
+        job.program = m_target;
+        job.args = lmc_splitArgs(runs.at(i));
+        job.stream = true;
+        job.workingDir = QFileInfo(m_target).absolutePath();
+        job.env << ("LLVM_PROFILE_FILE=" + dir.absoluteFilePath("train-%p.profraw"));
+        jobs << job;
+    }
+
+    log(QString("PGO 2/4: %1 training run(s)\n").arg(jobs.size()));
+    m_step = Train;
+    // one at a time, so runs don't skew each other's hot paths or interleave output
+    m_runner->setMaxJobs(1);
+    m_runner->setKeepGoing(true);
+    m_runner->start(jobs);
+}
+
+void PgoWorkflow::startMerge()
+{
+    const QDir dir(m_dir);
+    const QStringList raws = dir.entryList({"*.profraw"}, QDir::Files, QDir::Name);
+    if (raws.isEmpty()) {
+        log("❌ No training run wrote a profile.\n");
+        done(false);
+        return;
+    }
+
+    LmcJob job;
+    job.label = "llvm-profdata merge";
+    job.program = m_profdata.first();
+    job.args = m_profdata.mid(1);
+    job.args << "merge" << "-o" << dir.absoluteFilePath("merged.profdata");
+    for (const QString &raw : raws)
+        job.args << dir.absoluteFilePath(raw);
+
+    log(QString("PGO 3/4: merging %1 profile(s)\n").arg(raws.size()));
+    m_output.clear();
+    m_step = Merge;
+    m_runner->setKeepGoing(false);
+    m_runner->start({job});
+}
+
+void PgoWorkflow::onJobsFinished(bool ok)
+{
+    if (m_runner->wasCancelled()) {
+        done(false);
+        return;
+    }
+
+    if (m_step == Train) {
+        startMerge();
+    } else if (m_step == Merge) {
+        if (!ok) {
+            log(m_output);
+            log("❌ llvm-profdata merge failed.\n");
+            m_exitCode = qMax(m_runner->failureCode(), 1);
+            done(false);
+            return;
+        }
+        // coverage summary from the merged profile, per function
+        LmcJob job;
+        job.label = "llvm-profdata show";
+        job.program = m_profdata.first();
+        job.args = m_profdata.mid(1);
+        job.args << "show" << "--all-functions" << QDir(m_dir).absoluteFilePath("merged.profdata");
+        m_output.clear();
+        m_step = Summary;
+        m_runner->start({job});
+    } else if (m_step == Summary) {
+        static const QRegularExpression countRe("^\\s*Function count:\\s*(\\d+)",
+                                                QRegularExpression::MultilineOption);
+        int functions = 0;
+        int executed = 0;
+        auto it = countRe.globalMatch(m_output);
+        while (it.hasNext()) {
+            ++functions;
+            if (it.next().captured(1).toLongLong() > 0)
+                ++executed;
+        }
+        if (ok && functions > 0)
+            log(QString("Profile: %1 of %2 instrumented functions ran in training (%3%)\n")
+                    .arg(executed)
+                    .arg(functions)
+                    .arg(100.0 * executed / functions, 0, 'f', 1));
+        else
+            log("⚠️ Could not summarize the merged profile.\n");
+        startOptimize();
+    }
+}
+
+void PgoWorkflow::startOptimize()
+{
+    log("PGO 4/4: optimized build\n");
+    LmcBuildConfig optimized = m_config;
+    optimized.profileGenerate = false;
+    optimized.profileUse = QDir(m_dir).absoluteFilePath("merged.profdata");
+    m_step = Optimize;
+    if (!m_engine->start(optimized)) {
+        m_exitCode = m_engine->exitCode();
+        done(false);
+    }
+}
+
+// clang says so once per TU whose functions changed since the profile was taken
+void PgoWorkflow::reportStaleProfile()
+{
+    QFile f(QDir(BuildEngine::buildDirForTarget(m_target)).absoluteFilePath("build.log"));
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+    QStringList stale;
+    while (!f.atEnd()) {
+        const QString line = QString::fromUtf8(f.readLine()).trimmed();
+        if (line.contains("[-Wprofile-instr-"))
+            stale << line;
+    }
+    if (stale.isEmpty()) {
+        log("Profile matches the sources, no stale-profile warnings\n");
+        return;
+    }
+    log(QString("⚠️ %1 stale-profile warning(s), retrain after changing these sources:\n")
+            .arg(stale.size()));
+    for (const QString &line : std::as_const(stale))
+        log("  " + line + "\n");
+}
+
+void PgoWorkflow::log(const QString &s)
+{
+    m_engine->logSink()->append(s);
+}
+
+void PgoWorkflow::done(bool ok)
+{
+    m_step = Idle;
+    if (ok)
+        m_exitCode = 0;
+    else
+        log(m_cancelled ? "⚠️ PGO cancelled.\n" : "❌ PGO build failed.\n");
+    m_engine->logSink()->flush();
+    emit finished(ok, m_target);
+}
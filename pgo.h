@@ -0,0 +1,56 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QObject>
+#include <QStringList>
+#include "buildengine.h"
+
+class JobRunner;
+
+// profile-guided optimization on top of a BuildEngine, four steps in a row:
+// instrumented build -> training runs (config.pgoRuns) -> llvm-profdata merge ->
+// optimized build. profiles live in <build dir>/pgo/, the two builds' objects in
+// <build dir>/profiles/pgo-gen and pgo-use, progress goes to the engine's log.
+// the engine's own finished() fires for both builds, listen to this one's instead.
+class PgoWorkflow : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PgoWorkflow(BuildEngine *engine, QObject *parent = nullptr);
+
+    bool start(const LmcBuildConfig &config);
+    void cancel();
+    bool isRunning() const { return m_step != Idle; }
+
+    // 0 after a good optimized build, else whatever the failing step returned (or 1)
+    int exitCode() const { return m_exitCode; }
+
+    // llvm-profdata next to the compiler, then on PATH (xcrun's on macOS).
+    // program first, then leading arguments; empty when there is none
+    static QStringList profdataCommand(const QString &compiler);
+
+signals:
+    void finished(bool ok, const QString &target);
+
+private:
+    enum Step { Idle, Instrument, Train, Merge, Summary, Optimize };
+
+    void onBuildFinished(bool ok, const QString &target);
+    void onJobsFinished(bool ok);
+    void startTraining();
+    void startMerge();
+    void startOptimize();
+    void reportStaleProfile();
+    void log(const QString &s);
+    void done(bool ok);
+
+    BuildEngine *m_engine;
+    JobRunner *m_runner;
+    Step m_step = Idle;
+    LmcBuildConfig m_config;
+    QStringList m_profdata; // llvm-profdata command
+    QString m_target;
+    QString m_dir;          // <build dir>/pgo
+    QString m_output;       // of the last merge/show job
+    int m_exitCode = 0;
+    bool m_cancelled = false;
+};
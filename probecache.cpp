@@ -0,0 +1,235 @@
+// (c) 2025 Stardust Softworks
+#include "probecache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+
+// default search path of pkg-config itself, fingerprinted on the binary only
+static const char *kPcPathCmd = "pkg-config --variable pc_path pkg-config";
+// a probe that takes longer than this is hung (a brew auto-update, a wedged wrapper script)
+static const int kProbeTimeoutMs = 10000;
+
+static void lmc_hashStat(QCryptographicHash &h, const QString &path)
+{
+    const QFileInfo fi(path);
+    h.addData(path.toUtf8());
+    if (fi.exists()) {
+        h.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+        h.addData(QByteArray::number(fi.size()));
+    } else {
+        h.addData("-");
+    }
+}
+
+// package names on the Requires: / Requires.private: lines of a .pc, version constraints dropped
+static QStringList lmc_pcRequires(const QString &pcFile)
+{
+    QFile f(pcFile);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return {};
+    QStringList pkgs;
+    while (!f.atEnd()) {
+        const QString line = QString::fromUtf8(f.readLine()).trimmed();
+        if (!line.startsWith("Requires:") && !line.startsWith("Requires.private:"))
+            continue;
+        const QString list = line.mid(line.indexOf(':') + 1);
+        bool version = false; // the word after <, >=, = ... is a version, not a package
+        for (const QString &w : list.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts)) {
+            if (version) {
+                version = false;
+            } else if (w.contains(QRegularExpression("^[<>=!]+$"))) {
+                version = true;
+            } else if (!w.contains('$')) {
+                pkgs << w;
+            }
+        }
+    }
+    return pkgs;
+}
+
+ProbeCache::ProbeCache()
+{
+    m_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/probes.json";
+    load();
+}
+
+void ProbeCache::beginBuild()
+{
+    m_checked.clear();
+    m_hits = 0;
+    m_runs = 0;
+}
+
+QStringList ProbeCache::pkgConfigDirs()
+{
+    QStringList dirs;
+    const QString env = qEnvironmentVariable("PKG_CONFIG_PATH");
+    for (const QString &d : env.split(QDir::listSeparator(), Qt::SkipEmptyParts))
+        dirs << d;
+    for (const QString &d : result(kPcPathCmd).split(QDir::listSeparator(), Qt::SkipEmptyParts))
+        dirs << d;
+    return dirs;
+}
+
+QByteArray ProbeCache::fingerprint(const QString &command)
+{
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(qgetenv("PATH"));
+    h.addData(qgetenv("PKG_CONFIG_PATH"));
+
+    const QStringList words = command.split(' ', Qt::SkipEmptyParts);
+    const QString tool = words.value(0);
+    lmc_hashStat(h, QStandardPaths::findExecutable(tool));
+
+    // a package appears, disappears or gets upgraded -> its .pc (or the dir) changes.
+    // the flags also come from everything it Requires, so the whole closure is keyed
+    if (tool == "pkg-config" && command != kPcPathCmd) {
+        const QStringList dirs = pkgConfigDirs();
+        for (const QString &dir : dirs)
+            lmc_hashStat(h, dir);
+        QStringList todo;
+        for (int i = 1; i < words.size(); ++i)
+            if (!words.at(i).startsWith('-'))
+                todo << words.at(i);
+        QSet<QString> seen;
+        while (!todo.isEmpty()) {
+            const QString pkg = todo.takeFirst();
+            if (seen.contains(pkg))
+                continue;
+            seen.insert(pkg);
+            QString found; // the first hit on the search path is the one pkg-config reads
+            for (const QString &dir : dirs) {
+                const QString pc = dir + "/" + pkg + ".pc";
+                lmc_hashStat(h, pc);
+                if (found.isEmpty() && QFileInfo::exists(pc))
+                    found = pc;
+            }
+            if (!found.isEmpty())
+                todo << lmc_pcRequires(found);
+        }
+    }
+    return h.result().toHex();
+}
+
+bool ProbeCache::isFresh(const QString &command, QByteArray *fp)
+{
+    if (m_checked.contains(command))
+        return true;
+    *fp = fingerprint(command);
+    auto it = m_entries.constFind(command);
+    if (it == m_entries.constEnd() || it.value().fingerprint != *fp)
+        return false;
+    m_checked.insert(command);
+    ++m_hits;
+    return true;
+}
+
+QStringList ProbeCache::pending(const QStringList &commands)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(commands)
+    return {};
+#else
+    // pkg-config fingerprints stat its search path, which is a probe of its own
+    QByteArray fp;
+    for (const QString &cmd : commands) {
+        if (cmd.startsWith("pkg-config ") && !isFresh(kPcPathCmd, &fp)) {
+            m_pending.insert(kPcPathCmd, fp);
+            return {kPcPathCmd};
+        }
+    }
+    QStringList misses;
+    for (const QString &cmd : commands) {
+        if (misses.contains(cmd) || isFresh(cmd, &fp))
+            continue;
+        misses << cmd;
+        m_pending.insert(cmd, fp);
+    }
+    return misses;
+#endif
+}
+
+void ProbeCache::store(const QString &command, const QString &output)
+{
+    m_entries.insert(command, {m_pending.take(command), output.trimmed()});
+    m_checked.insert(command);
+    ++m_runs;
+}
+
+void ProbeCache::resolve(const QStringList &commands)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(commands)
+#else
+    for (QStringList misses = pending(commands); !misses.isEmpty(); misses = pending(commands)) {
+        // fork them all, then collect: the wall time is the slowest probe, not the sum
+        QVector<QProcess *> procs;
+        for (const QString &cmd : std::as_const(misses)) {
+            auto *sh = new QProcess;
+            sh->setStandardInputFile(QProcess::nullDevice());
+            sh->start("/bin/sh", {"-c", cmd});
+            procs << sh;
+        }
+        for (int i = 0; i < procs.size(); ++i) {
+            QProcess *sh = procs.at(i);
+            if (!sh->waitForFinished(kProbeTimeoutMs)) {
+                sh->kill();
+                m_pending.insert(misses.at(i), QByteArray()); // empty this time, retried next build
+            }
+            store(misses.at(i), QString::fromLocal8Bit(sh->readAllStandardOutput()));
+            delete sh;
+        }
+        save();
+    }
+#endif
+}
+
+QString ProbeCache::result(const QString &command)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(command)
+    return QString();
+#else
+    resolve({command});
+    return m_entries.value(command).output;
+#endif
+}
+
+void ProbeCache::load()
+{
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly))
+        return;
+    const QJsonObject root = QJsonDocument::fromJson(f.readAll()).object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        const QJsonObject e = it.value().toObject();
+        m_entries.insert(it.key(),
+                         {e.value("fp").toString().toLatin1(), e.value("out").toString()});
+    }
+}
+
+void ProbeCache::save() const
+{
+    QJsonObject root;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        QJsonObject e;
+        e.insert("fp", QString::fromLatin1(it.value().fingerprint));
+        e.insert("out", it.value().output);
+        root.insert(it.key(), e);
+    }
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile out(m_path);
+    if (out.open(QIODevice::WriteOnly)) {
+        out.write(QJsonDocument(root).toJson());
+        out.commit();
+    }
+}
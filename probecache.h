@@ -0,0 +1,53 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+// remembers the output of pkg-config / sdl2-config / brew shell probes across runs.
+// an entry stays valid while PATH, PKG_CONFIG_PATH, the tool binary and (for
+// pkg-config) the matching .pc files, the ones they Requires and their directories
+// are unchanged, so a warm build costs a handful of stat() calls instead of a fork per probe.
+class ProbeCache
+{
+public:
+    ProbeCache();
+
+    // forget what was validated last build and zero the counters
+    void beginBuild();
+
+    // the commands that have to run before result() can answer from the cache. ask again
+    // after store()ing them: pkg-config's own search path comes back alone first
+    QStringList pending(const QStringList &commands);
+    // trimmed stdout of a pending command that ran, written out by save()
+    void store(const QString &command, const QString &output);
+    void save() const;
+
+    // pending() + store() in place, each probe bounded by a timeout (bench and stragglers)
+    void resolve(const QStringList &commands);
+    // trimmed stdout of `/bin/sh -c command`, runs it on the spot when not resolved yet
+    QString result(const QString &command);
+
+    int hits() const { return m_hits; }
+    int runs() const { return m_runs; }
+
+private:
+    struct Entry
+    {
+        QByteArray fingerprint;
+        QString output;
+    };
+
+    bool isFresh(const QString &command, QByteArray *fp);
+    QByteArray fingerprint(const QString &command);
+    QStringList pkgConfigDirs();
+    void load();
+
+    QString m_path;
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_checked; // validated since beginBuild()
+    QHash<QString, QByteArray> m_pending; // command -> fingerprint taken before it ran
+    int m_hits = 0;
+    int m_runs = 0;
+};
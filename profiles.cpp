@@ -0,0 +1,70 @@
+// (c) 2025 Stardust Softworks
+#include "profiles.h"
+#include <QDir>
+#include <QRegularExpression>
+#include <QSettings>
+
+QVector<LmcProfile> lmc_builtinProfiles()
+{
+    return {
+        {"Debug", {"-O0", "-g"}, {}},
+        {"Release", {"-O3", "-DNDEBUG"}, {}},
+        {"RelWithDebInfo", {"-O2", "-g", "-DNDEBUG"}, {}},
+        // the sanitizer runtimes come in through the same flags at link time
+        {"ASan+UBSan",
+         {"-O1", "-g", "-fsanitize=address,undefined", "-fno-omit-frame-pointer"},
+         {}},
+    };
+}
+
+QVector<LmcProfile> lmc_loadProfiles()
+{
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    if (!settings.contains("profiles/size"))
+        return lmc_builtinProfiles();
+
+    QVector<LmcProfile> profiles;
+    const int n = settings.beginReadArray("profiles");
+    for (int i = 0; i < n; ++i) {
+        settings.setArrayIndex(i);
+        LmcProfile p;
+        p.name = settings.value("name").toString();
+        p.cxxflags = settings.value("cxxflags").toStringList();
+        p.ldflags = settings.value("ldflags").toStringList();
+        if (!p.name.isEmpty())
+            profiles << p;
+    }
+    settings.endArray();
+    return profiles;
+}
+
+void lmc_saveProfiles(const QVector<LmcProfile> &profiles)
+{
+    QSettings settings("StardustSoftworks", "LazyMansClang");
+    settings.remove("profiles");
+    settings.beginWriteArray("profiles", profiles.size());
+    for (int i = 0; i < profiles.size(); ++i) {
+        settings.setArrayIndex(i);
+        settings.setValue("name", profiles.at(i).name);
+        settings.setValue("cxxflags", profiles.at(i).cxxflags);
+        settings.setValue("ldflags", profiles.at(i).ldflags);
+    }
+    settings.endArray();
+}
+
+int lmc_findProfile(const QVector<LmcProfile> &profiles, const QString &name)
+{
+    for (int i = 0; i < profiles.size(); ++i)
+        if (profiles.at(i).name.compare(name, Qt::CaseInsensitive) == 0)
+            return i;
+    return -1;
+}
+
+QString lmc_profileBuildDir(const QString &buildDir, const QString &name)
+{
+    static const QRegularExpression unsafe("[^a-z0-9._-]+");
+    QString dir = name.toLower().replace(unsafe, "-");
+    if (dir.isEmpty() || dir.startsWith('.'))
+        dir.prepend("profile");
+    return QDir(buildDir).absoluteFilePath("profiles/" + dir);
+}
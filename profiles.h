@@ -0,0 +1,27 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QStringList>
+#include <QVector>
+
+// a named set of flags layered under the C++/linker flag boxes (one entry per line,
+// same as the boxes). each profile builds into its own directory under the target's
+// build dir, so going back to one that was built before is a relink at most.
+struct LmcProfile
+{
+    QString name;
+    QStringList cxxflags;
+    QStringList ldflags;
+};
+
+// Debug, Release, RelWithDebInfo, ASan+UBSan
+QVector<LmcProfile> lmc_builtinProfiles();
+
+// the list kept in QSettings ("profiles"), the built-ins until it was first saved
+QVector<LmcProfile> lmc_loadProfiles();
+void lmc_saveProfiles(const QVector<LmcProfile> &profiles);
+
+// index of the profile called name (case-insensitive), -1 when there is none
+int lmc_findProfile(const QVector<LmcProfile> &profiles, const QString &name);
+
+// <buildDir>/profiles/<name made filesystem-safe>
+QString lmc_profileBuildDir(const QString &buildDir, const QString &name);
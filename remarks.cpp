@@ -0,0 +1,260 @@
+// (c) 2025 Stardust Softworks
+#include "remarks.h"
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include "demangle.h"
+
+LmcRemark::Category LmcRemark::category() const
+{
+    if (pass == "loop-vectorize" || pass == "slp-vectorizer")
+        return Vectorize;
+    if (pass == "inline")
+        return Inline;
+    if (pass == "gvn")
+        return Gvn;
+    return Other;
+}
+
+QString lmc_remarksPath(const QString &obj)
+{
+    QString base = obj;
+    if (base.endsWith(".o"))
+        base.chop(2);
+    return base + ".opt.yaml";
+}
+
+// a YAML scalar the way LLVM's writer emits them: plain, 'single' ('' escapes a quote)
+// or "double" (backslash escapes). quoted ones may run over several lines. *consumed is
+// where the value ended, past the end of text while a quote is still open
+static QString lmc_scalar(const QByteArray &text, int *consumed = nullptr)
+{
+    const QByteArray s = text.trimmed();
+    if (s.isEmpty() || (s.at(0) != '\'' && s.at(0) != '"')) {
+        if (consumed)
+            *consumed = text.size();
+        return QString::fromUtf8(s);
+    }
+    const int start = text.indexOf(s.at(0));
+    const char quote = s.at(0);
+    QByteArray value;
+    int i = start + 1;
+    for (; i < text.size(); ++i) {
+        const char c = text.at(i);
+        if (quote == '\'' && c == '\'') {
+            if (i + 1 < text.size() && text.at(i + 1) == '\'') {
+                value += '\'';
+                ++i;
+                continue;
+            }
+            break;
+        }
+        if (quote == '"' && c == '\\' && i + 1 < text.size()) {
+            const char e = text.at(++i);
+            value += e == 'n' ? '\n' : e == 't' ? '\t' : e;
+            continue;
+        }
+        if (quote == '"' && c == '"')
+            break;
+        if (c == '\n') {
+            // a folded line break reads as one space, the indentation after it doesn't count
+            value += ' ';
+            while (i + 1 < text.size() && (text.at(i + 1) == ' ' || text.at(i + 1) == '\t'))
+                ++i;
+            continue;
+        }
+        value += c;
+    }
+    if (consumed)
+        *consumed = i + 1;
+    return QString::fromUtf8(value);
+}
+
+// { File: a.cpp, Line: 12, Column: 5 }, File may be quoted
+static void lmc_debugLoc(const QByteArray &text, LmcRemark *r)
+{
+    QByteArray s = text.trimmed();
+    if (s.startsWith('{'))
+        s = s.mid(1);
+    if (s.endsWith('}'))
+        s.chop(1);
+    while (!s.trimmed().isEmpty()) {
+        s = s.trimmed();
+        const int colon = s.indexOf(':');
+        if (colon < 0)
+            return;
+        const QByteArray key = s.left(colon).trimmed();
+        QByteArray rest = s.mid(colon + 1).trimmed();
+        QString value;
+        if (rest.startsWith('\'') || rest.startsWith('"')) {
+            int used = 0;
+            value = lmc_scalar(rest, &used);
+            rest = rest.mid(used);
+        } else {
+            const int comma = rest.indexOf(',');
+            value = QString::fromUtf8((comma < 0 ? rest : rest.left(comma)).trimmed());
+            rest = comma < 0 ? QByteArray() : rest.mid(comma);
+        }
+        const int comma = rest.indexOf(',');
+        s = comma < 0 ? QByteArray() : rest.mid(comma + 1);
+        if (key == "File")
+            r->file = value;
+        else if (key == "Line")
+            r->line = value.toInt();
+        else if (key == "Column")
+            r->column = value.toInt();
+    }
+}
+
+// "Key:   value" -> key, value (everything after the colon)
+static bool lmc_keyValue(const QByteArray &line, QByteArray *key, QByteArray *value)
+{
+    const int colon = line.indexOf(':');
+    if (colon < 0)
+        return false;
+    *key = line.left(colon).trimmed();
+    *value = line.mid(colon + 1);
+    return true;
+}
+
+// an unfinished quoted value keeps going on the next line
+static bool lmc_openQuote(const QByteArray &value)
+{
+    const QByteArray s = value.trimmed();
+    if (s.isEmpty() || (s.at(0) != '\'' && s.at(0) != '"'))
+        return false;
+    int used = 0;
+    lmc_scalar(value, &used);
+    return used > value.size();
+}
+
+bool lmc_readRemarks(const QString &path, QVector<LmcRemark> *out)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    const QList<QByteArray> lines = f.readAll().split('\n');
+
+    // inlining remarks repeat once per inliner round, keep the first
+    QSet<QString> seen;
+    LmcRemark r;
+    bool inDoc = false;
+    bool skip = false;
+    bool inArgs = false;
+    QStringList args;
+
+    auto finish = [&] {
+        if (inDoc && !skip) {
+            r.message = args.join(QString());
+            const QString key = QStringList{QString::number(r.kind), r.pass, r.name, r.file,
+                                            QString::number(r.line), QString::number(r.column),
+                                            r.message}
+                                    .join('|');
+            if (!seen.contains(key)) {
+                seen.insert(key);
+                out->append(r);
+            }
+        }
+        inDoc = false;
+    };
+
+    for (int i = 0; i < lines.size(); ++i) {
+        QByteArray line = lines.at(i);
+        if (line.endsWith('\r'))
+            line.chop(1);
+
+        if (line.startsWith("--- !")) {
+            finish();
+            const QByteArray tag = line.mid(5).trimmed();
+            r = LmcRemark();
+            args.clear();
+            inDoc = true;
+            inArgs = false;
+            skip = tag == "Passed";
+            if (tag == "Missed")
+                r.kind = LmcRemark::Missed;
+            else if (tag == "Failure")
+                r.kind = LmcRemark::Failure;
+            else
+                r.kind = LmcRemark::Analysis; // Analysis, AnalysisFPCommute, AnalysisAliasing
+            continue;
+        }
+        if (line == "...") {
+            finish();
+            continue;
+        }
+        if (!inDoc || skip || line.trimmed().isEmpty())
+            continue;
+
+        QByteArray key;
+        QByteArray value;
+        if (!lmc_keyValue(line, &key, &value))
+            continue;
+        // a quoted value that spans lines gets its continuation lines glued on
+        while (lmc_openQuote(value) && i + 1 < lines.size())
+            value += '\n' + lines.at(++i);
+
+        const bool topLevel = !line.startsWith(' ');
+        if (topLevel) {
+            inArgs = key == "Args";
+            if (key == "Pass")
+                r.pass = lmc_scalar(value);
+            else if (key == "Name")
+                r.name = lmc_scalar(value);
+            else if (key == "DebugLoc")
+                lmc_debugLoc(value, &r);
+            else if (key == "Function")
+                r.function = lmc_demangle(lmc_scalar(value));
+            continue;
+        }
+        // "  - Callee: foo" starts an argument, "    DebugLoc: {...}" belongs to the one before
+        if (!inArgs || !key.startsWith('-'))
+            continue;
+        const QByteArray argKey = key.mid(1).trimmed();
+        if (argKey == "DebugLoc")
+            continue;
+        QString text = lmc_scalar(value);
+        if (argKey == "Callee" || argKey == "Caller")
+            text = lmc_demangle(text);
+        args << text;
+    }
+    finish();
+    return true;
+}
+
+QString lmc_remarksSummary(const QVector<LmcRemark> &remarks, int top)
+{
+    if (remarks.isEmpty())
+        return "Optimization remarks: none (no -O level, or nothing was missed)\n";
+
+    int counts[4] = {0, 0, 0, 0};
+    QVector<const LmcRemark *> highlighted;
+    for (const LmcRemark &r : remarks) {
+        ++counts[r.category()];
+        if (r.category() != LmcRemark::Other && r.kind != LmcRemark::Analysis)
+            highlighted << &r;
+    }
+    QString text = QString("Optimization remarks: %1 vectorization, %2 inlining, %3 GVN, "
+                           "%4 other\n")
+                       .arg(counts[LmcRemark::Vectorize])
+                       .arg(counts[LmcRemark::Inline])
+                       .arg(counts[LmcRemark::Gvn])
+                       .arg(counts[LmcRemark::Other]);
+    std::stable_sort(highlighted.begin(), highlighted.end(),
+                     [](const LmcRemark *a, const LmcRemark *b) {
+                         if (a->file != b->file)
+                             return a->file < b->file;
+                         return a->line < b->line;
+                     });
+    for (int i = 0; i < highlighted.size() && i < top; ++i) {
+        const LmcRemark *r = highlighted.at(i);
+        text += QString("  %1:%2: [%3] %4 (%5)\n")
+                    .arg(r->file.isEmpty() ? QString("?") : r->file, QString::number(r->line),
+                         r->pass, r->message, r->function);
+    }
+    if (highlighted.size() > top)
+        text += QString("  … %1 more missed, see the remarks panel\n")
+                    .arg(highlighted.size() - top);
+    return text;
+}
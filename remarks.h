@@ -0,0 +1,33 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QStringList>
+#include <QVector>
+
+// one entry of clang's -fsave-optimization-record YAML (<object>.opt.yaml). passed
+// remarks are skipped while reading, they're most of the file and never the question
+struct LmcRemark
+{
+    enum Kind { Missed, Analysis, Failure };
+    // what the remarks view highlights
+    enum Category { Other, Vectorize, Inline, Gvn };
+
+    Kind kind = Missed;
+    QString pass;     // "loop-vectorize", "inline", "gvn", ...
+    QString name;     // the remark's id within its pass, "MissedDetails" and friends
+    QString file;     // empty when clang had no debug location
+    int line = 0;
+    int column = 0;
+    QString function; // demangled where possible
+    QString message;  // the Args put together, the way -Rpass-missed prints them
+
+    Category category() const;
+};
+
+// where clang puts the record for obj (-o x.o -> x.opt.yaml)
+QString lmc_remarksPath(const QString &obj);
+
+// appends the file's remarks in the order clang wrote them, false when it's missing
+bool lmc_readRemarks(const QString &path, QVector<LmcRemark> *out);
+
+// counts per category plus the first few highlighted remarks, ready for the log
+QString lmc_remarksSummary(const QVector<LmcRemark> &remarks, int top = 20);
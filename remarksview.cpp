@@ -0,0 +1,210 @@
+// (c) 2025 Stardust Softworks
+#include "remarksview.h"
+#include <QColor>
+#include <QComboBox>
+#include <QCompleter>
+#include <QDesktopServices>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHash>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSet>
+#include <QTreeWidget>
+#include <QUrl>
+#include <QVBoxLayout>
+#include <algorithm>
+
+// more than this and the tree gets sluggish, narrow it down instead
+static const int kMaxShown = 20000;
+
+enum { PathRole = Qt::UserRole, LineRole, RankRole };
+
+// translucent, so it reads on light and dark themes alike
+static QColor lmc_categoryColor(LmcRemark::Category category)
+{
+    switch (category) {
+    case LmcRemark::Vectorize: return QColor(220, 60, 60, 70);
+    case LmcRemark::Inline: return QColor(240, 150, 0, 70);
+    case LmcRemark::Gvn: return QColor(150, 90, 220, 70);
+    default: return QColor();
+    }
+}
+
+static QString lmc_kindName(LmcRemark::Kind kind)
+{
+    switch (kind) {
+    case LmcRemark::Missed: return "missed";
+    case LmcRemark::Failure: return "failure";
+    default: return "analysis";
+    }
+}
+
+RemarksView::RemarksView(QWidget *parent)
+    : QWidget(parent)
+{
+    functionEdit = new QLineEdit(this);
+    functionEdit->setPlaceholderText(tr("Function"));
+    functionEdit->setClearButtonEnabled(true);
+    connect(functionEdit, &QLineEdit::textChanged, this, &RemarksView::rebuild);
+
+    categoryBox = new QComboBox(this);
+    categoryBox->addItem(tr("Vectorization, Inlining, GVN"), -2);
+    categoryBox->addItem(tr("Vectorization"), int(LmcRemark::Vectorize));
+    categoryBox->addItem(tr("Inlining"), int(LmcRemark::Inline));
+    categoryBox->addItem(tr("GVN"), int(LmcRemark::Gvn));
+    categoryBox->addItem(tr("All Passes"), -1);
+    connect(categoryBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            &RemarksView::rebuild);
+
+    summaryLabel = new QLabel(this);
+
+    tree = new QTreeWidget(this);
+    tree->setColumnCount(4);
+    tree->setHeaderLabels({tr("Location"), tr("Pass"), tr("Remark"), tr("Function")});
+    tree->setUniformRowHeights(true);
+    tree->setWordWrap(false);
+    tree->header()->setSectionResizeMode(2, QHeaderView::Stretch);
+    connect(tree, &QTreeWidget::itemDoubleClicked, this, &RemarksView::openItem);
+
+    auto *bar = new QHBoxLayout;
+    bar->addWidget(functionEdit, 1);
+    bar->addWidget(categoryBox);
+    bar->addWidget(summaryLabel);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(bar);
+    layout->addWidget(tree);
+    rebuild();
+}
+
+void RemarksView::clear()
+{
+    setRemarks({});
+}
+
+void RemarksView::setRemarks(const QVector<LmcRemark> &list)
+{
+    remarks = list;
+    std::stable_sort(remarks.begin(), remarks.end(), [](const LmcRemark &a, const LmcRemark &b) {
+        if (a.file != b.file)
+            return a.file < b.file;
+        if (a.line != b.line)
+            return a.line < b.line;
+        return a.column < b.column;
+    });
+
+    // every function that has something to say, for the completer
+    QSet<QString> seen;
+    QStringList functions;
+    for (const LmcRemark &r : std::as_const(remarks)) {
+        if (!r.function.isEmpty() && !seen.contains(r.function)) {
+            seen.insert(r.function);
+            functions << r.function;
+        }
+    }
+    functions.sort();
+    auto *completer = new QCompleter(functions, functionEdit);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setFilterMode(Qt::MatchContains);
+    delete functionEdit->completer();
+    functionEdit->setCompleter(completer);
+    rebuild();
+}
+
+void RemarksView::rebuild()
+{
+    tree->clear();
+    const QString function = functionEdit->text().trimmed();
+    const int category = categoryBox->currentData().toInt();
+
+    QHash<QString, QTreeWidgetItem *> files;
+    QTreeWidgetItem *lineItem = nullptr;
+    QString lastFile;
+    int lastLine = -1;
+    int shown = 0;
+    int matching = 0;
+    for (const LmcRemark &r : std::as_const(remarks)) {
+        const LmcRemark::Category cat = r.category();
+        if (category == -2 && cat == LmcRemark::Other)
+            continue;
+        if (category >= 0 && int(cat) != category)
+            continue;
+        if (!function.isEmpty() && !r.function.contains(function, Qt::CaseInsensitive))
+            continue;
+        if (++matching > kMaxShown)
+            continue;
+        ++shown;
+
+        QTreeWidgetItem *fileItem = files.value(r.file);
+        if (!fileItem) {
+            fileItem = new QTreeWidgetItem(tree);
+            fileItem->setText(0, r.file.isEmpty() ? tr("(no location)")
+                                                  : QFileInfo(r.file).fileName());
+            fileItem->setToolTip(0, r.file);
+            fileItem->setData(0, PathRole, r.file);
+            fileItem->setData(0, LineRole, 0);
+            files.insert(r.file, fileItem);
+        }
+        if (!lineItem || r.file != lastFile || r.line != lastLine) {
+            lineItem = new QTreeWidgetItem(fileItem);
+            lineItem->setText(0, tr("line %1").arg(r.line));
+            lineItem->setData(0, PathRole, r.file);
+            lineItem->setData(0, LineRole, r.line);
+            lineItem->setData(0, RankRole, -1);
+            lastFile = r.file;
+            lastLine = r.line;
+        }
+
+        auto *item = new QTreeWidgetItem(lineItem);
+        item->setText(0, QString("%1:%2").arg(r.line).arg(r.column));
+        item->setText(1, r.pass);
+        item->setText(2, r.message);
+        item->setText(3, r.function);
+        item->setToolTip(2, QString("%1 %2/%3: %4").arg(lmc_kindName(r.kind), r.pass, r.name,
+                                                        r.message));
+        item->setToolTip(3, r.function);
+        item->setData(0, PathRole, r.file);
+        item->setData(0, LineRole, r.line);
+
+        // the line shows its most telling remark: a highlighted analysis (the reason),
+        // then any highlighted one, then whatever came first
+        int rank = 0;
+        if (cat != LmcRemark::Other) {
+            rank = r.kind == LmcRemark::Analysis ? 2 : 1;
+            for (int c = 0; c < 4; ++c)
+                item->setBackground(c, lmc_categoryColor(cat));
+        }
+        if (rank > lineItem->data(0, RankRole).toInt()) {
+            lineItem->setData(0, RankRole, rank);
+            lineItem->setText(1, r.pass);
+            lineItem->setText(2, r.message);
+            lineItem->setText(3, r.function);
+            for (int c = 0; c < 4; ++c)
+                lineItem->setBackground(c, item->background(c));
+        }
+    }
+
+    // files arrive in path order already, the remarks were sorted in setRemarks()
+    for (QTreeWidgetItem *fileItem : std::as_const(files)) {
+        int count = 0;
+        for (int i = 0; i < fileItem->childCount(); ++i)
+            count += fileItem->child(i)->childCount();
+        fileItem->setText(2, tr("%n remark(s)", nullptr, count));
+        fileItem->setExpanded(true);
+    }
+
+    QString text = tr("%1 of %2 remark(s)").arg(shown).arg(remarks.size());
+    if (matching > shown)
+        text += tr(", %1 more hidden, narrow it down").arg(matching - shown);
+    summaryLabel->setText(text);
+}
+
+void RemarksView::openItem(QTreeWidgetItem *item)
+{
+    const QString path = item->data(0, PathRole).toString();
+    if (!path.isEmpty() && QFileInfo::exists(path))
+        QDesktopServices::openUrl(QUrl::fromLocalFile(path));
+}
@@ -0,0 +1,34 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QVector>
+#include <QWidget>
+#include "remarks.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+// a build's optimization remarks grouped by file, then line: a loop's "not vectorized"
+// sits next to the analysis that says why. vectorization, inlining and GVN misses are
+// highlighted, the function box narrows it down to one function
+class RemarksView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit RemarksView(QWidget *parent = nullptr);
+
+    void clear();
+    void setRemarks(const QVector<LmcRemark> &remarks);
+
+private:
+    void rebuild();
+    void openItem(QTreeWidgetItem *item);
+
+    QVector<LmcRemark> remarks; // sorted by file, line, column
+    QLineEdit *functionEdit{};
+    QComboBox *categoryBox{};
+    QLabel *summaryLabel{};
+    QTreeWidget *tree{};
+};
@@ -0,0 +1,495 @@
+// (c) 2025 Stardust Softworks
+#include "runbench.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#include <QProcess>
+#endif
+#ifdef Q_OS_LINUX
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+static const int kMaxRuns = 200; // records kept per history file, oldest go first
+
+#ifdef Q_OS_LINUX
+// counts the child from its exec() on, -1 without a PMU (most VMs) or permission
+static int lmc_perfCounter(pid_t pid, quint64 config)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.inherit = 1;        // the program's threads count too
+    attr.exclude_kernel = 1; // all that perf_event_paranoid=2, the default, lets us see
+    attr.exclude_hv = 1;
+    return int(syscall(__NR_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+#ifdef Q_OS_UNIX
+// close-on-exec from the start: a fork() on another thread must not inherit either end
+static bool lmc_cloexecPipe(int fds[2])
+{
+#ifdef Q_OS_LINUX
+    return pipe2(fds, O_CLOEXEC) == 0;
+#else
+    // no pipe2() on macOS, the flags go on right after
+    if (pipe(fds) != 0)
+        return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+#endif
+
+bool lmc_runOnce(const QString &program, const QStringList &args, LmcRunSample *out,
+                 QString *error, LmcRunningPid *running)
+{
+    *out = LmcRunSample();
+    auto fail = [error](const QString &why) {
+        *error = why;
+        return false;
+    };
+#ifdef Q_OS_UNIX
+    // everything the child needs is ready before fork(), after it only async-signal-safe calls
+    QByteArray path = QFile::encodeName(program);
+    const QByteArray dir = QFile::encodeName(QFileInfo(program).absolutePath());
+    QVector<QByteArray> argBytes{path};
+    for (const QString &a : args)
+        argBytes << a.toLocal8Bit();
+    QVector<char *> argv;
+    for (QByteArray &a : argBytes)
+        argv << a.data();
+    argv << nullptr;
+
+    // go: the parent has its counters attached. execFailed: closed by a good exec(), else errno
+    int go[2];
+    int execFailed[2];
+    if (!lmc_cloexecPipe(go))
+        return fail("pipe() failed");
+    if (!lmc_cloexecPipe(execFailed)) {
+        close(go[0]);
+        close(go[1]);
+        return fail("pipe() failed");
+    }
+    const int devNull = open("/dev/null", O_RDWR | O_CLOEXEC);
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        char c;
+        if (read(go[0], &c, 1) != 1)
+            _exit(127);
+        if (devNull >= 0) {
+            dup2(devNull, 0);
+            dup2(devNull, 1);
+            dup2(devNull, 2);
+        }
+        int err = 0;
+        if (chdir(dir.constData()) == 0)
+            execv(path.constData(), argv.data());
+        err = errno;
+        ssize_t written = write(execFailed[1], &err, sizeof err);
+        (void)written;
+        _exit(127);
+    }
+    close(go[0]);
+    close(execFailed[1]);
+    if (devNull >= 0)
+        close(devNull);
+    if (pid < 0) {
+        close(go[1]);
+        close(execFailed[0]);
+        return fail(QString("fork() failed: %1").arg(strerror(errno)));
+    }
+    if (running) {
+        QMutexLocker locker(&running->lock);
+        running->pid = pid;
+    }
+
+    int counters[3] = {-1, -1, -1};
+#ifdef Q_OS_LINUX
+    const quint64 kinds[3] = {PERF_COUNT_HW_CPU_CYCLES,
+                              PERF_COUNT_HW_INSTRUCTIONS,
+                              PERF_COUNT_HW_CACHE_MISSES};
+    for (int i = 0; i < 3; ++i)
+        counters[i] = lmc_perfCounter(pid, kinds[i]);
+#endif
+
+    QElapsedTimer timer;
+    timer.start();
+    ssize_t sent = write(go[1], "x", 1);
+    (void)sent;
+    close(go[1]);
+
+    int err = 0;
+    const bool execOk = read(execFailed[0], &err, sizeof err) != ssize_t(sizeof err);
+    close(execFailed[0]);
+
+    // wait without reaping, so a kill from cancel() can't hit a recycled pid
+    siginfo_t info;
+    while (waitid(P_PID, id_t(pid), &info, WEXITED | WNOWAIT) < 0 && errno == EINTR) {
+    }
+    out->wallNs = timer.nsecsElapsed();
+    if (running) {
+        QMutexLocker locker(&running->lock);
+        running->pid = 0;
+    }
+    int status = 0;
+    struct rusage usage;
+    std::memset(&usage, 0, sizeof usage);
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+
+    qint64 *values[3] = {&out->cycles, &out->instructions, &out->cacheMisses};
+    for (int i = 0; i < 3; ++i) {
+        quint64 v = 0;
+        if (counters[i] >= 0 && read(counters[i], &v, sizeof v) == ssize_t(sizeof v))
+            *values[i] = qint64(v);
+        if (counters[i] >= 0)
+            close(counters[i]);
+    }
+#ifdef Q_OS_MAC
+    out->maxRssKb = usage.ru_maxrss / 1024; // bytes there, kilobytes on Linux
+#else
+    out->maxRssKb = usage.ru_maxrss;
+#endif
+
+    if (!execOk)
+        return fail(QString("could not start %1: %2").arg(program, strerror(err)));
+    if (WIFSIGNALED(status))
+        return fail(QString("killed by signal %1").arg(WTERMSIG(status)));
+    out->exitCode = WEXITSTATUS(status);
+    return true;
+#else
+    Q_UNUSED(running);
+    QProcess p;
+    p.setProgram(program);
+    p.setArguments(args);
+    p.setWorkingDirectory(QFileInfo(program).absolutePath());
+    p.setStandardInputFile(QProcess::nullDevice());
+    p.setStandardOutputFile(QProcess::nullDevice());
+    p.setStandardErrorFile(QProcess::nullDevice());
+    QElapsedTimer timer;
+    timer.start();
+    p.start();
+    if (!p.waitForStarted(-1))
+        return fail(p.errorString());
+    p.waitForFinished(-1);
+    out->wallNs = timer.nsecsElapsed();
+    if (p.exitStatus() == QProcess::CrashExit)
+        return fail("crashed");
+    out->exitCode = p.exitCode();
+    return true;
+#endif
+}
+
+void lmc_killRun(LmcRunningPid *running)
+{
+#ifdef Q_OS_UNIX
+    QMutexLocker locker(&running->lock);
+    if (running->pid > 0)
+        kill(pid_t(running->pid), SIGKILL);
+#else
+    Q_UNUSED(running);
+#endif
+}
+
+QString lmc_binaryStamp(const QString &program)
+{
+    const QFileInfo fi(program);
+    return QString("%1:%2").arg(fi.lastModified().toMSecsSinceEpoch()).arg(fi.size());
+}
+
+LmcRunStats lmc_runStats(const QVector<LmcRunSample> &samples)
+{
+    LmcRunStats s;
+    s.runs = samples.size();
+    if (samples.isEmpty())
+        return s;
+
+    QVector<double> ms;
+    for (const LmcRunSample &r : samples)
+        ms << r.wallNs / 1e6;
+    std::sort(ms.begin(), ms.end());
+    double sum = 0;
+    for (double v : std::as_const(ms))
+        sum += v;
+    s.meanMs = sum / ms.size();
+    s.minMs = ms.first();
+    s.medianMs = ms.size() % 2 ? ms.at(ms.size() / 2)
+                               : (ms.at(ms.size() / 2 - 1) + ms.at(ms.size() / 2)) / 2;
+    double var = 0;
+    for (double v : std::as_const(ms))
+        var += (v - s.meanMs) * (v - s.meanMs);
+    s.stddevMs = ms.size() > 1 ? std::sqrt(var / (ms.size() - 1)) : 0;
+
+    // counters: mean of the runs that had them
+    auto mean = [&](qint64 LmcRunSample::*field) {
+        double total = 0;
+        int n = 0;
+        for (const LmcRunSample &r : samples) {
+            if (r.*field >= 0) {
+                total += r.*field;
+                ++n;
+            }
+        }
+        return n > 0 ? total / n : -1.0;
+    };
+    s.cycles = mean(&LmcRunSample::cycles);
+    s.instructions = mean(&LmcRunSample::instructions);
+    s.cacheMisses = mean(&LmcRunSample::cacheMisses);
+    for (const LmcRunSample &r : samples)
+        s.peakRssKb = qMax(s.peakRssKb, r.maxRssKb);
+    return s;
+}
+
+// "41.2 M"
+static QString lmc_count(double v)
+{
+    if (v >= 1e9)
+        return QString::number(v / 1e9, 'f', 2) + " G";
+    if (v >= 1e6)
+        return QString::number(v / 1e6, 'f', 1) + " M";
+    if (v >= 1e3)
+        return QString::number(v / 1e3, 'f', 1) + " k";
+    return QString::number(v, 'f', 0);
+}
+
+QString lmc_formatRunStats(const LmcRunStats &s)
+{
+    QString text = QString("  wall: %1 ms mean, %2 ms median, ±%3 ms, %4 ms min (%5 run(s))\n")
+                       .arg(s.meanMs, 0, 'f', 2)
+                       .arg(s.medianMs, 0, 'f', 2)
+                       .arg(s.stddevMs, 0, 'f', 2)
+                       .arg(s.minMs, 0, 'f', 2)
+                       .arg(s.runs);
+    if (s.peakRssKb >= 0)
+        text += QString("  peak RSS: %1 MB\n").arg(s.peakRssKb / 1024.0, 0, 'f', 1);
+
+    QStringList counters;
+    if (s.cycles >= 0)
+        counters << lmc_count(s.cycles) + " cycles";
+    if (s.instructions >= 0)
+        counters << lmc_count(s.instructions) + " instructions";
+    if (s.cycles > 0 && s.instructions >= 0)
+        counters << QString("%1 IPC").arg(s.instructions / s.cycles, 0, 'f', 2);
+    if (s.cacheMisses >= 0)
+        counters << lmc_count(s.cacheMisses) + " cache misses";
+    if (!counters.isEmpty())
+        text += "  counters (user space, per run): " + counters.join(", ") + "\n";
+    else
+        text += "  no hardware counters (Linux only, needs a PMU and perf_event_paranoid <= 2)\n";
+    return text;
+}
+
+static QJsonObject lmc_recordToJson(const LmcRunRecord &r)
+{
+    QJsonObject o;
+    o.insert("when", r.when.toString(Qt::ISODate));
+    o.insert("profile", r.profile);
+    o.insert("flags", QJsonArray::fromStringList(r.flags));
+    o.insert("binary", r.binary);
+    o.insert("args", QJsonArray::fromStringList(r.args));
+    o.insert("runs", r.stats.runs);
+    o.insert("meanMs", r.stats.meanMs);
+    o.insert("medianMs", r.stats.medianMs);
+    o.insert("stddevMs", r.stats.stddevMs);
+    o.insert("minMs", r.stats.minMs);
+    o.insert("peakRssKb", r.stats.peakRssKb);
+    o.insert("cycles", r.stats.cycles);
+    o.insert("instructions", r.stats.instructions);
+    o.insert("cacheMisses", r.stats.cacheMisses);
+    return o;
+}
+
+static LmcRunRecord lmc_recordFromJson(const QJsonObject &o)
+{
+    LmcRunRecord r;
+    r.when = QDateTime::fromString(o.value("when").toString(), Qt::ISODate);
+    r.profile = o.value("profile").toString();
+    for (const QJsonValue &v : o.value("flags").toArray())
+        r.flags << v.toString();
+    r.binary = o.value("binary").toString();
+    for (const QJsonValue &v : o.value("args").toArray())
+        r.args << v.toString();
+    r.stats.runs = o.value("runs").toInt();
+    r.stats.meanMs = o.value("meanMs").toDouble();
+    r.stats.medianMs = o.value("medianMs").toDouble();
+    r.stats.stddevMs = o.value("stddevMs").toDouble();
+    r.stats.minMs = o.value("minMs").toDouble();
+    r.stats.peakRssKb = qint64(o.value("peakRssKb").toDouble(-1));
+    r.stats.cycles = o.value("cycles").toDouble(-1);
+    r.stats.instructions = o.value("instructions").toDouble(-1);
+    r.stats.cacheMisses = o.value("cacheMisses").toDouble(-1);
+    return r;
+}
+
+// what the new record changed against the last one of its profile
+static QString lmc_compareRuns(const LmcRunRecord &prev, const LmcRunRecord &cur)
+{
+    const QString profile = cur.profile.isEmpty() ? QString("unprofiled") : cur.profile;
+    QString text = QString("  vs the previous %1 run (%2): ")
+                       .arg(profile, prev.when.toLocalTime().toString("yyyy-MM-dd HH:mm"));
+
+    const double a = prev.stats.meanMs;
+    const double b = cur.stats.meanMs;
+    const double noise = qMax(prev.stats.stddevMs, cur.stats.stddevMs);
+    if (a <= 0 || b <= 0)
+        text += "no timing to compare";
+    else if (std::abs(a - b) <= noise)
+        text += QString("within noise, %1 → %2 ms mean").arg(a, 0, 'f', 2).arg(b, 0, 'f', 2);
+    else if (b < a)
+        text += QString("%1x faster, %2 → %3 ms mean").arg(a / b, 0, 'f', 2).arg(a, 0, 'f', 2)
+                    .arg(b, 0, 'f', 2);
+    else
+        text += QString("⚠️ %1x slower, %2 → %3 ms mean").arg(b / a, 0, 'f', 2).arg(a, 0, 'f', 2)
+                    .arg(b, 0, 'f', 2);
+    if (prev.stats.instructions > 0 && cur.stats.instructions >= 0)
+        text += QString(", instructions %1%2%")
+                    .arg(cur.stats.instructions >= prev.stats.instructions ? "+" : "")
+                    .arg(100.0 * (cur.stats.instructions - prev.stats.instructions)
+                             / prev.stats.instructions,
+                         0, 'f', 1);
+    text += "\n";
+    if (prev.args != cur.args)
+        text += "  ⚠️ run arguments differ: " + prev.args.join(" ") + " → " + cur.args.join(" ")
+                + "\n";
+
+    if (prev.binary == cur.binary) {
+        text += "  same build as that run\n";
+        return text;
+    }
+    const QSet<QString> before(prev.flags.begin(), prev.flags.end());
+    const QSet<QString> after(cur.flags.begin(), cur.flags.end());
+    QStringList changes;
+    for (const QString &f : cur.flags)
+        if (!before.contains(f))
+            changes << "+" + f;
+    for (const QString &f : prev.flags)
+        if (!after.contains(f))
+            changes << "-" + f;
+    text += changes.isEmpty() ? QString("  rebuilt with the same flags\n")
+                              : "  flags since then: " + changes.join(" ") + "\n";
+    return text;
+}
+
+QString lmc_runHistoryPath(const QString &buildDir)
+{
+    return QDir(buildDir).absoluteFilePath("lmc_runs.history");
+}
+
+QString lmc_fileRun(const QString &historyPath, const LmcRunRecord &record)
+{
+    QJsonArray runs;
+    QFile f(historyPath);
+    if (f.open(QIODevice::ReadOnly))
+        runs = QJsonDocument::fromJson(f.readAll()).array();
+    f.close();
+
+    QString comparison;
+    for (int i = runs.size() - 1; i >= 0; --i) {
+        const LmcRunRecord prev = lmc_recordFromJson(runs.at(i).toObject());
+        if (prev.profile == record.profile) {
+            comparison = lmc_compareRuns(prev, record);
+            break;
+        }
+    }
+
+    runs.append(lmc_recordToJson(record));
+    while (runs.size() > kMaxRuns)
+        runs.removeFirst();
+    QDir().mkpath(QFileInfo(historyPath).absolutePath());
+    QSaveFile out(historyPath);
+    if (out.open(QIODevice::WriteOnly)) {
+        out.write(QJsonDocument(runs).toJson());
+        out.commit();
+    }
+    return comparison;
+}
+
+RunBenchmark::RunBenchmark(QObject *parent)
+    : QObject(parent)
+{}
+
+RunBenchmark::~RunBenchmark()
+{
+    if (m_thread) {
+        cancel();
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+bool RunBenchmark::start(const QString &program, const QStringList &args, int warmup, int runs)
+{
+    if (m_thread || runs < 1)
+        return false;
+    m_cancel = false;
+    m_samples.clear();
+    m_error.clear();
+    m_stats = LmcRunStats();
+
+    const int total = qMax(0, warmup) + runs;
+    m_thread = QThread::create([this, program, args, warmup, total] {
+        for (int i = 0; i < total && !m_cancel; ++i) {
+            LmcRunSample sample;
+            QString error;
+            if (!lmc_runOnce(program, args, &sample, &error, &m_running)) {
+                m_error = QString("run %1: %2").arg(i + 1).arg(error);
+                return;
+            }
+            if (sample.exitCode != 0) {
+                m_error = QString("run %1 exited with code %2").arg(i + 1).arg(sample.exitCode);
+                return;
+            }
+            if (i >= warmup)
+                m_samples << sample;
+            emit progress(i + 1, total); // queued, this object lives on the main thread
+        }
+    });
+    connect(m_thread, &QThread::finished, this, &RunBenchmark::onThreadFinished);
+    m_thread->start();
+    return true;
+}
+
+void RunBenchmark::cancel()
+{
+    m_cancel = true;
+    lmc_killRun(&m_running);
+}
+
+void RunBenchmark::onThreadFinished()
+{
+    m_thread->deleteLater();
+    m_thread = nullptr;
+    const bool ok = !m_cancel && m_error.isEmpty() && !m_samples.isEmpty();
+    if (ok)
+        m_stats = lmc_runStats(m_samples);
+    else if (m_cancel)
+        m_error = "cancelled";
+    emit finished(ok);
+}
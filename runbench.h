@@ -0,0 +1,104 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QDateTime>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+class QThread;
+
+// one run of the built program. -1 wherever the platform or the kernel said no
+struct LmcRunSample
+{
+    qint64 wallNs = 0;
+    qint64 maxRssKb = -1;     // wait4() rusage, not on Windows
+    qint64 cycles = -1;       // perf_event_open, Linux only, user space only
+    qint64 instructions = -1;
+    qint64 cacheMisses = -1;
+    int exitCode = 0;
+};
+
+struct LmcRunStats
+{
+    int runs = 0;
+    double meanMs = 0;
+    double medianMs = 0;
+    double stddevMs = 0;
+    double minMs = 0;
+    qint64 peakRssKb = -1;
+    double cycles = -1; // means over the runs that had counters
+    double instructions = -1;
+    double cacheMisses = -1;
+};
+
+// what the run history keeps per benchmark: which profile, flags and binary it was
+struct LmcRunRecord
+{
+    QDateTime when;
+    QString profile;      // empty: no profile
+    QStringList flags;    // BuildEngine::buildFlags() of the build that made the binary
+    QString binary;       // mtime:size of the target, tells builds apart
+    QStringList args;
+    LmcRunStats stats;
+};
+
+// the run in flight, so another thread can kill it. while pid is set under the lock the
+// process is at worst a zombie, never reaped, so the pid can't have been reused
+struct LmcRunningPid
+{
+    QMutex lock;
+    qint64 pid = 0;
+};
+
+// blocking: one run with stdin/stdout/stderr on the null device, timed from exec to exit.
+// Windows has no running pid to kill, cancelling waits for the run to end there
+bool lmc_runOnce(const QString &program, const QStringList &args, LmcRunSample *out,
+                 QString *error, LmcRunningPid *running = nullptr);
+void lmc_killRun(LmcRunningPid *running);
+
+// mtime:size of the built program, what tells one build of it from the next
+QString lmc_binaryStamp(const QString &program);
+
+LmcRunStats lmc_runStats(const QVector<LmcRunSample> &samples);
+QString lmc_formatRunStats(const LmcRunStats &stats);
+
+// build/lmc_runs.history, JSON. named so clean() leaves it alone, like lmc_tu.history
+QString lmc_runHistoryPath(const QString &buildDir);
+
+// appends to the target's run history (one per build dir, capped), returns how the record
+// compares with the previous one of the same profile, empty when there is none
+QString lmc_fileRun(const QString &historyPath, const LmcRunRecord &record);
+
+// runs the target warmup + runs times on a worker thread, one after another so runs
+// don't compete for cores and caches. results go to the engine's log through the caller
+class RunBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RunBenchmark(QObject *parent = nullptr);
+    ~RunBenchmark();
+
+    bool start(const QString &program, const QStringList &args, int warmup, int runs);
+    void cancel();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    // valid after finished(true)
+    LmcRunStats stats() const { return m_stats; }
+    QString error() const { return m_error; }
+
+signals:
+    void progress(int done, int total);
+    void finished(bool ok);
+
+private:
+    void onThreadFinished();
+
+    QThread *m_thread = nullptr;
+    std::atomic_bool m_cancel{false};
+    LmcRunningPid m_running;
+    QVector<LmcRunSample> m_samples; // written by the worker only, read once it's done
+    QString m_error;
+    LmcRunStats m_stats;
+};
@@ -0,0 +1,175 @@
+// (c) 2025 Stardust Softworks
+#include "sourcelist.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QRegularExpression>
+#include <QVector>
+#include <algorithm>
+
+// QRegularExpression::wildcardToRegularExpression() treats / differently across Qt
+// versions, so the few glob rules here are spelled out
+static QRegularExpression lmc_globRegex(const QString &glob)
+{
+    QString rx;
+    for (int i = 0; i < glob.size(); ++i) {
+        const QChar c = glob.at(i);
+        if (c == '*' && i + 1 < glob.size() && glob.at(i + 1) == '*') {
+            // "**/" may also stand for no folder at all, src/**/gen/* matches src/gen/a.cpp
+            if (i + 2 < glob.size() && glob.at(i + 2) == '/') {
+                rx += "(?:.*/)?";
+                i += 2;
+            } else {
+                rx += ".*";
+                ++i;
+            }
+        } else if (c == '*') {
+            rx += "[^/]*";
+        } else if (c == '?') {
+            rx += "[^/]";
+        } else {
+            rx += QRegularExpression::escape(QString(c));
+        }
+    }
+#ifdef Q_OS_WIN
+    return QRegularExpression("^" + rx + "$", QRegularExpression::CaseInsensitiveOption);
+#else
+    return QRegularExpression("^" + rx + "$");
+#endif
+}
+
+struct LmcGlob
+{
+    QRegularExpression rx;
+    bool path = false; // has a /, matched against the whole relative path
+};
+
+static QVector<LmcGlob> lmc_globs(const QStringList &patterns)
+{
+    QVector<LmcGlob> globs;
+    for (const QString &p : patterns) {
+        if (p.trimmed().isEmpty())
+            continue;
+        const QString glob = QDir::fromNativeSeparators(p.trimmed());
+        globs << LmcGlob{lmc_globRegex(glob), glob.contains('/')};
+    }
+    return globs;
+}
+
+QStringList lmc_findSources(const QString &root, const QStringList &include,
+                            const QStringList &exclude)
+{
+    const QVector<LmcGlob> includes = lmc_globs(include);
+    const QVector<LmcGlob> excludes = lmc_globs(exclude);
+    const QDir base(root);
+
+    QStringList found;
+    QDirIterator it(root, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QString rel = base.relativeFilePath(path);
+        const QStringList parts = rel.split('/');
+
+        bool wanted = includes.isEmpty();
+        for (const LmcGlob &g : includes) {
+            if (g.rx.match(g.path ? rel : parts.last()).hasMatch()) {
+                wanted = true;
+                break;
+            }
+        }
+        for (int i = 0; wanted && i < excludes.size(); ++i) {
+            const LmcGlob &g = excludes.at(i);
+            if (g.path) {
+                wanted = !g.rx.match(rel).hasMatch();
+                continue;
+            }
+            for (const QString &part : parts) {
+                if (g.rx.match(part).hasMatch()) {
+                    wanted = false;
+                    break;
+                }
+            }
+        }
+        if (wanted)
+            found << QDir::cleanPath(path);
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+SourceListModel::SourceListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{}
+
+int SourceListModel::addFiles(const QStringList &files)
+{
+    QStringList fresh;
+    for (const QString &f : files) {
+        if (f.isEmpty() || m_known.contains(f))
+            continue;
+        m_known.insert(f);
+        fresh << f;
+    }
+    if (fresh.isEmpty())
+        return 0;
+    // one insert for the lot, the view relays out once
+    beginInsertRows(QModelIndex(), m_files.size(), m_files.size() + fresh.size() - 1);
+    m_files << fresh;
+    endInsertRows();
+    return fresh.size();
+}
+
+void SourceListModel::removeFiles(const QModelIndexList &rows)
+{
+    if (rows.isEmpty())
+        return;
+    QVector<bool> gone(m_files.size(), false);
+    for (const QModelIndex &index : rows)
+        if (index.isValid() && index.row() < m_files.size())
+            gone[index.row()] = true;
+
+    // one pass instead of a removal per row, a big selection would be quadratic otherwise
+    beginResetModel();
+    QStringList kept;
+    kept.reserve(m_files.size());
+    for (int i = 0; i < m_files.size(); ++i) {
+        if (gone.at(i))
+            m_known.remove(m_files.at(i));
+        else
+            kept << m_files.at(i);
+    }
+    m_files = kept;
+    endResetModel();
+}
+
+void SourceListModel::setFiles(const QStringList &files)
+{
+    beginResetModel();
+    m_files.clear();
+    m_known.clear();
+    for (const QString &f : files) {
+        if (f.isEmpty() || m_known.contains(f))
+            continue;
+        m_known.insert(f);
+        m_files << f;
+    }
+    endResetModel();
+}
+
+void SourceListModel::clear()
+{
+    setFiles({});
+}
+
+int SourceListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_files.size();
+}
+
+QVariant SourceListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_files.size())
+        return {};
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole)
+        return m_files.at(index.row());
+    return {};
+}
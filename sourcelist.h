@@ -0,0 +1,36 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QAbstractListModel>
+#include <QSet>
+#include <QStringList>
+
+// files under root (recursively, hidden directories skipped) whose name matches one of
+// include and whose path relative to root matches none of exclude, sorted. globs: * and
+// ? stay within one path component, ** crosses them. a pattern without a / is matched
+// against the file name for include and against every path component for exclude
+QStringList lmc_findSources(const QString &root, const QStringList &include,
+                            const QStringList &exclude);
+
+// the project's file list. a hash set of paths keeps adding n files O(n) however many
+// are listed, and the view asks only for the rows it shows, so 10,000 files load as fast
+// as 10
+class SourceListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit SourceListModel(QObject *parent = nullptr);
+
+    // appends the ones not listed yet, returns how many that was
+    int addFiles(const QStringList &files);
+    void removeFiles(const QModelIndexList &rows);
+    void setFiles(const QStringList &files);
+    void clear();
+    const QStringList &files() const { return m_files; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    QStringList m_files;
+    QSet<QString> m_known;
+};
@@ -0,0 +1,333 @@
+// (c) 2025 Stardust Softworks
+#include "sourcescan.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <cstring>
+
+// bump when LmcSourceInfo or the scanner's rules change
+static const quint32 kScanCacheVersion = 1;
+// forget files we haven't seen lately once the cache grows past this
+static const int kScanCacheMaxEntries = 20000;
+
+static inline bool lmc_isIdent(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool lmc_isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// same rule as the old \bint\s+main\s*\( regex, p[i] is the 'm'
+static bool lmc_matchMain(const char *p, qint64 n, qint64 i)
+{
+    if (i + 4 > n || std::memcmp(p + i, "main", 4) != 0)
+        return false;
+    if (i + 4 < n && lmc_isIdent(p[i + 4]))
+        return false;
+
+    qint64 j = i + 4;
+    while (j < n && lmc_isSpace(p[j]))
+        ++j;
+    if (j >= n || p[j] != '(')
+        return false;
+
+    qint64 k = i - 1;
+    if (k < 0 || !lmc_isSpace(p[k]))
+        return false;
+    while (k >= 0 && lmc_isSpace(p[k]))
+        --k;
+    if (k < 2 || std::memcmp(p + k - 2, "int", 3) != 0)
+        return false;
+    return k < 3 || !lmc_isIdent(p[k - 3]);
+}
+
+// p[i] is the '#', returns the index of the line end
+static qint64 lmc_parseDirective(const char *p, qint64 n, qint64 i, LmcSourceInfo &info)
+{
+    const char *nl = static_cast<const char *>(std::memchr(p + i, '\n', size_t(n - i)));
+    const qint64 end = nl ? nl - p : n;
+
+    qint64 j = i + 1;
+    while (j < end && (p[j] == ' ' || p[j] == '\t'))
+        ++j;
+    if (end - j < 7 || std::memcmp(p + j, "include", 7) != 0)
+        return end;
+    j += 7;
+    while (j < end && (p[j] == ' ' || p[j] == '\t'))
+        ++j;
+    if (j >= end)
+        return end;
+
+    const char open = p[j];
+    const char close = open == '<' ? '>' : open == '"' ? '"' : 0;
+    if (!close)
+        return end;
+    const qint64 start = ++j;
+    while (j < end && p[j] != close)
+        ++j;
+    if (j < end && j > start) {
+        const QString name = QString::fromUtf8(p + start, int(j - start));
+        if (close == '>')
+            info.systemIncludes << name;
+        else
+            info.localIncludes << name;
+    }
+    return end;
+}
+
+static void lmc_scanBytes(const char *p, qint64 n, LmcSourceInfo &info)
+{
+    qint64 i = 0;
+    bool lineStart = true;
+    while (i < n) {
+        const char c = p[i];
+        if (c == '\n') {
+            lineStart = true;
+            ++i;
+            continue;
+        }
+        if (lineStart && (c == ' ' || c == '\t')) {
+            ++i;
+            continue;
+        }
+        if (lineStart && c == '#') {
+            i = lmc_parseDirective(p, n, i, info);
+            continue;
+        }
+        lineStart = false;
+
+        // main() already found: only line starts matter now, hop line to line
+        if (info.hasMain) {
+            const char *nl = static_cast<const char *>(std::memchr(p + i, '\n', size_t(n - i)));
+            i = nl ? nl - p : n;
+            continue;
+        }
+        if (c == 'm' && (i == 0 || !lmc_isIdent(p[i - 1])) && lmc_matchMain(p, n, i))
+            info.hasMain = true;
+        ++i;
+    }
+}
+
+LmcSourceInfo SourceScanner::scanFile(const QString &path)
+{
+    LmcSourceInfo info;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return info;
+    const qint64 n = f.size();
+    if (n <= 0)
+        return info;
+
+    if (uchar *mem = f.map(0, n)) {
+        lmc_scanBytes(reinterpret_cast<const char *>(mem), n, info);
+        f.unmap(mem);
+    } else {
+        const QByteArray data = f.readAll();
+        lmc_scanBytes(data.constData(), data.size(), info);
+    }
+    return info;
+}
+
+SourceScanner::SourceScanner()
+{
+    m_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/scan.dat";
+    load();
+}
+
+QVector<LmcSourceInfo> SourceScanner::scan(const QStringList &paths)
+{
+    m_reused = 0;
+    m_scanned = 0;
+
+    for (const QString &p : paths)
+        m_touched.insert(p);
+
+    QVector<LmcSourceInfo> results(paths.size());
+    QVector<int> misses;
+    QVector<Cached> stats(paths.size());
+    for (int i = 0; i < paths.size(); ++i) {
+        const QFileInfo fi(paths.at(i));
+        stats[i].mtime = fi.lastModified().toMSecsSinceEpoch();
+        stats[i].size = fi.size();
+
+        auto it = m_cache.constFind(paths.at(i));
+        if (it != m_cache.constEnd() && it.value().mtime == stats[i].mtime
+            && it.value().size == stats[i].size) {
+            results[i] = it.value().info;
+            ++m_reused;
+        } else {
+            misses << i;
+        }
+    }
+    if (misses.isEmpty())
+        return results;
+
+    // every worker writes its own slot, the vector is not resized meanwhile
+    LmcSourceInfo *out = results.data();
+    QThreadPool pool;
+    for (const int i : std::as_const(misses)) {
+        const QString path = paths.at(i);
+        pool.start([out, i, path] { out[i] = scanFile(path); });
+    }
+    pool.waitForDone();
+
+    if (m_cache.size() + misses.size() > kScanCacheMaxEntries) {
+        QHash<QString, Cached> kept;
+        for (const QString &p : std::as_const(m_touched))
+            if (m_cache.contains(p))
+                kept.insert(p, m_cache.value(p));
+        m_cache.swap(kept);
+    }
+    for (const int i : std::as_const(misses)) {
+        Cached c = stats.at(i);
+        c.info = results.at(i);
+        m_cache.insert(paths.at(i), c);
+    }
+    m_scanned = misses.size();
+    m_dirty = true;
+    return results;
+}
+
+QSet<QString> SourceScanner::includeClosure(const QStringList &sources,
+                                            const QVector<LmcSourceInfo> &infos,
+                                            const QStringList &includeDirs)
+{
+    QSet<QString> system;
+    QSet<QString> visited;
+    QHash<QString, QString> resolved; // "dir|name" -> path, empty if not found
+    m_headerPaths.clear();
+
+    // the sources' common folder, or just their own folders when that is a filesystem root
+    QStringList sourceDirs;
+    for (const QString &src : sources) {
+        const QString dir = QDir::cleanPath(QFileInfo(src).absolutePath());
+        if (!sourceDirs.contains(dir))
+            sourceDirs << dir;
+    }
+    QString root = sourceDirs.value(0);
+    for (const QString &dir : std::as_const(sourceDirs)) {
+        while (!root.isEmpty() && dir != root && !dir.startsWith(root + '/'))
+            root = root.contains('/') ? root.left(root.lastIndexOf('/')) : QString();
+    }
+    const QStringList projectRoots = root.isEmpty() || QDir(root).isRoot()
+                                         ? sourceDirs
+                                         : QStringList{root};
+    QStringList projectIncludeDirs;
+    for (const QString &inc : includeDirs) {
+        const QString dir = QDir::cleanPath(QFileInfo(inc).absoluteFilePath());
+        for (const QString &r : projectRoots) {
+            if (dir == r || dir.startsWith(r + '/')) {
+                projectIncludeDirs << dir;
+                break;
+            }
+        }
+    }
+
+    auto lookup = [&](const QString &name, const QString &fromDir) -> QString {
+        const QString key = fromDir + '|' + name;
+        auto it = resolved.constFind(key);
+        if (it != resolved.constEnd())
+            return it.value();
+
+        QString hit;
+        if (!fromDir.isEmpty()) {
+            const QString p = QDir::cleanPath(fromDir + '/' + name);
+            if (QFileInfo::exists(p))
+                hit = p;
+        }
+        for (int i = 0; hit.isEmpty() && i < projectIncludeDirs.size(); ++i) {
+            const QString p = QDir::cleanPath(projectIncludeDirs.at(i) + '/' + name);
+            if (QFileInfo::exists(p))
+                hit = p;
+        }
+        resolved.insert(key, hit);
+        return hit;
+    };
+
+    QStringList level;
+    for (const QString &src : sources) {
+        const QString p = QDir::cleanPath(QFileInfo(src).absoluteFilePath());
+        visited.insert(p);
+        level << p;
+    }
+    QVector<LmcSourceInfo> levelInfos = infos;
+
+    // breadth-first, one parallel scan() per level, every header at most once
+    while (!level.isEmpty()) {
+        QStringList next;
+        for (int i = 0; i < level.size(); ++i) {
+            const QString dir = QFileInfo(level.at(i)).absolutePath();
+            const LmcSourceInfo &info = levelInfos.at(i);
+
+            for (const QString &inc : info.localIncludes) {
+                const QString path = lookup(inc, dir);
+                if (path.isEmpty()) {
+                    system.insert(inc);
+                } else if (!visited.contains(path)) {
+                    visited.insert(path);
+                    next << path;
+                }
+            }
+            for (const QString &inc : info.systemIncludes)
+                system.insert(inc);
+        }
+        if (next.isEmpty())
+            break;
+        m_headerPaths << next;
+        levelInfos = scan(next);
+        level = next;
+    }
+    return system;
+}
+
+void SourceScanner::load()
+{
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly))
+        return;
+    QDataStream in(&f);
+    quint32 version = 0;
+    in >> version;
+    if (version != kScanCacheVersion)
+        return;
+
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Cached c;
+        in >> path >> c.mtime >> c.size >> c.info.hasMain >> c.info.systemIncludes
+            >> c.info.localIncludes;
+        m_cache.insert(path, c);
+    }
+    if (in.status() != QDataStream::Ok)
+        m_cache.clear();
+}
+
+void SourceScanner::commit()
+{
+    if (!m_dirty)
+        return;
+    m_dirty = false;
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile f(m_path);
+    if (!f.open(QIODevice::WriteOnly))
+        return;
+    QDataStream out(&f);
+    out << kScanCacheVersion << qint32(m_cache.size());
+    for (auto it = m_cache.constBegin(); it != m_cache.constEnd(); ++it) {
+        const Cached &c = it.value();
+        out << it.key() << c.mtime << c.size << c.info.hasMain << c.info.systemIncludes
+            << c.info.localIncludes;
+    }
+    f.commit();
+}
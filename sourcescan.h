@@ -0,0 +1,64 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+// what BuildEngine needs to know about a source before compiling it
+struct LmcSourceInfo
+{
+    bool hasMain = false;       // `int main(` somewhere in the file
+    QStringList systemIncludes; // #include <...>
+    QStringList localIncludes;  // #include "..."
+};
+
+// one pass over the raw bytes of each file (memory-mapped, never decoded as a
+// whole), files scanned in parallel. results are remembered per path by mtime
+// and size, across runs, so untouched files cost one stat() per build.
+class SourceScanner
+{
+public:
+    SourceScanner();
+
+    // results line up with paths
+    QVector<LmcSourceInfo> scan(const QStringList &paths);
+
+    // walks the project's own headers reachable from sources (whose infos came from
+    // scan()). only quoted includes are followed: next to the includer, then in the
+    // includeDirs inside the project (under the sources' common folder), so an
+    // -I/usr/include never walks system headers. returns every <...> name seen in the
+    // tree, plus quoted names that didn't resolve (probably a library header too).
+    QSet<QString> includeClosure(const QStringList &sources,
+                                 const QVector<LmcSourceInfo> &infos,
+                                 const QStringList &includeDirs);
+    int headersWalked() const { return m_headerPaths.size(); }
+    // the headers themselves, from the last includeClosure()
+    const QStringList &headerPaths() const { return m_headerPaths; }
+
+    // write the cache file if anything was scanned
+    void commit();
+
+    int reused() const { return m_reused; }
+    int scanned() const { return m_scanned; }
+
+    static LmcSourceInfo scanFile(const QString &path);
+
+private:
+    struct Cached
+    {
+        qint64 mtime = 0;
+        qint64 size = 0;
+        LmcSourceInfo info;
+    };
+
+    void load();
+
+    QString m_path;
+    QHash<QString, Cached> m_cache;
+    QSet<QString> m_touched; // paths asked for this session, survive pruning
+    bool m_dirty = false;
+    int m_reused = 0;
+    int m_scanned = 0;
+    QStringList m_headerPaths;
+};
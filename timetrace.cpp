@@ -0,0 +1,189 @@
+// (c) 2025 Stardust Softworks
+#include "timetrace.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include "demangle.h"
+
+namespace {
+
+struct Cost
+{
+    qint64 micros = 0;
+    int count = 0;
+};
+
+using CostTable = QHash<QString, Cost>;
+
+// what one TU's trace contributes
+struct TuTrace
+{
+    bool found = false;
+    CostTable headers;
+    CostTable templates;
+    CostTable backend;
+    qint64 frontend = 0;
+    qint64 backendTotal = 0;
+    QJsonArray events;
+};
+
+} // namespace
+
+QString lmc_timeTracePath(const QString &obj)
+{
+    const QFileInfo fi(obj);
+    return fi.absolutePath() + "/" + fi.completeBaseName() + ".json";
+}
+
+static void lmc_addCost(CostTable &table, const QString &key, qint64 micros)
+{
+    Cost &c = table[key];
+    c.micros += micros;
+    ++c.count;
+}
+
+static TuTrace lmc_readTrace(const QString &path)
+{
+    TuTrace tu;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return tu;
+    const QJsonArray events
+        = QJsonDocument::fromJson(f.readAll()).object().value("traceEvents").toArray();
+    tu.found = !events.isEmpty();
+
+    for (const QJsonValue &v : events) {
+        const QJsonObject e = v.toObject();
+        if (e.value("ph").toString() != "X")
+            continue;
+        const QString name = e.value("name").toString();
+        const qint64 dur = qint64(e.value("dur").toDouble());
+        const QString detail = e.value("args").toObject().value("detail").toString();
+
+        // nested includes overlap their includer, so header time is inclusive
+        if (name == "Source")
+            lmc_addCost(tu.headers, detail, dur);
+        else if (name == "InstantiateClass" || name == "InstantiateFunction")
+            lmc_addCost(tu.templates, detail, dur);
+        else if (name == "OptFunction")
+            lmc_addCost(tu.backend, detail, dur);
+        else if (name == "Total Frontend")
+            tu.frontend += dur;
+        else if (name == "Total Backend")
+            tu.backendTotal += dur;
+    }
+    tu.events = events;
+    return tu;
+}
+
+static void lmc_merge(CostTable &into, const CostTable &from)
+{
+    for (auto it = from.constBegin(); it != from.constEnd(); ++it) {
+        Cost &c = into[it.key()];
+        c.micros += it.value().micros;
+        c.count += it.value().count;
+    }
+}
+
+static QString lmc_ms(qint64 micros)
+{
+    return QString::number(micros / 1000);
+}
+
+static QString lmc_topTable(const QString &title, const CostTable &table, int top, bool demangle)
+{
+    QVector<QPair<QString, Cost>> rows;
+    rows.reserve(table.size());
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it)
+        rows.append({it.key(), it.value()});
+    std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+        return a.second.micros > b.second.micros;
+    });
+
+    QString out = title + "\n";
+    if (rows.isEmpty())
+        return out + "   (nothing recorded)\n";
+    for (int i = 0; i < rows.size() && i < top; ++i) {
+        const QString name = demangle ? lmc_demangle(rows.at(i).first) : rows.at(i).first;
+        out += QString("%1 ms  ×%2  %3\n")
+                   .arg(lmc_ms(rows.at(i).second.micros), 8)
+                   .arg(rows.at(i).second.count, -5)
+                   .arg(name.left(200));
+    }
+    return out;
+}
+
+QString lmc_timeTraceReport(const QStringList &objects, const QString &mergedPath, int top)
+{
+    // traces run to megabytes each, parse them side by side
+    QVector<TuTrace> traces(objects.size());
+    TuTrace *out = traces.data();
+    QThreadPool pool;
+    for (int i = 0; i < objects.size(); ++i) {
+        const QString path = lmc_timeTracePath(objects.at(i));
+        pool.start([out, i, path] { out[i] = lmc_readTrace(path); });
+    }
+    pool.waitForDone();
+
+    CostTable headers, templates, backend;
+    qint64 frontend = 0, backendTotal = 0;
+    int missing = 0;
+    QJsonArray merged;
+    for (int i = 0; i < traces.size(); ++i) {
+        const TuTrace &tu = traces.at(i);
+        if (!tu.found) {
+            ++missing;
+            continue;
+        }
+        lmc_merge(headers, tu.headers);
+        lmc_merge(templates, tu.templates);
+        lmc_merge(backend, tu.backend);
+        frontend += tu.frontend;
+        backendTotal += tu.backendTotal;
+
+        // one process per TU, named after its object
+        const int pid = i + 1;
+        QJsonObject meta;
+        meta.insert("name", "process_name");
+        meta.insert("ph", "M");
+        meta.insert("pid", pid);
+        meta.insert("args", QJsonObject{{"name", QFileInfo(objects.at(i)).completeBaseName()}});
+        merged << meta;
+        for (const QJsonValue &v : tu.events) {
+            QJsonObject e = v.toObject();
+            e.insert("pid", pid);
+            merged << e;
+        }
+    }
+
+    QString report = QString("Time trace: %1 TU(s)").arg(objects.size() - missing);
+    if (missing > 0)
+        report += QString(", %1 without a trace").arg(missing);
+    report += QString(", frontend %1 ms, backend %2 ms\n")
+                  .arg(lmc_ms(frontend), lmc_ms(backendTotal));
+    if (missing == objects.size())
+        return report;
+
+    report += lmc_topTable("Most expensive headers (inclusive parse time):", headers, top, false);
+    report += lmc_topTable("Most expensive template instantiations:", templates, top, false);
+    report += lmc_topTable("Most expensive backend functions:", backend, top, true);
+
+    QJsonObject root;
+    root.insert("traceEvents", merged);
+    root.insert("displayTimeUnit", "ms");
+    QSaveFile f(mergedPath);
+    if (f.open(QIODevice::WriteOnly)) {
+        f.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        if (f.commit())
+            report += "Merged trace: " + mergedPath + "\n";
+    }
+    return report;
+}
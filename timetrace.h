@@ -0,0 +1,13 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QStringList>
+
+// clang -ftime-trace leaves <object>.json next to each object; this is where
+// the one for obj lives
+QString lmc_timeTracePath(const QString &obj);
+
+// reads the traces of every object (in parallel), ranks headers by total
+// inclusive parse time, template instantiations and backend functions across
+// the whole project, and writes all traces into one file (one process per TU)
+// for Perfetto. returns the report, ready for the log.
+QString lmc_timeTraceReport(const QStringList &objects, const QString &mergedPath, int top = 10);
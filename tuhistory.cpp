@@ -0,0 +1,72 @@
+// (c) 2025 Stardust Softworks
+#include "tuhistory.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+// per #include in lmc_compileWeight(), in KB of source
+static const double kIncludeWeight = 16;
+// ms per unit of weight until something has been timed, about 0.8 s for a 20 KB file
+// that includes ten headers
+static const double kDefaultMsPerWeight = 4;
+
+static QString lmc_tuHistoryPath(const QString &buildDir)
+{
+    return QDir(buildDir).absoluteFilePath("lmc_tu.history");
+}
+
+QHash<QString, LmcTuHistory> lmc_readTuHistory(const QString &buildDir)
+{
+    QHash<QString, LmcTuHistory> history;
+    QFile f(lmc_tuHistoryPath(buildDir));
+    if (!f.open(QIODevice::ReadOnly))
+        return history;
+    const QJsonObject root = QJsonDocument::fromJson(f.readAll()).object();
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        const QJsonObject o = it.value().toObject();
+        LmcTuHistory h;
+        h.peakRssKb = qMax<qint64>(0, o.value("peakRssKb").toVariant().toLongLong());
+        h.compileMs = qMax<qint64>(0, o.value("compileMs").toVariant().toLongLong());
+        history.insert(it.key(), h);
+    }
+    return history;
+}
+
+bool lmc_writeTuHistory(const QString &buildDir, const QHash<QString, LmcTuHistory> &history)
+{
+    QJsonObject root;
+    for (auto it = history.cbegin(); it != history.cend(); ++it) {
+        QJsonObject o;
+        if (it.value().peakRssKb > 0)
+            o.insert("peakRssKb", it.value().peakRssKb);
+        if (it.value().compileMs > 0)
+            o.insert("compileMs", it.value().compileMs);
+        root.insert(it.key(), o);
+    }
+    QSaveFile f(lmc_tuHistoryPath(buildDir));
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return f.commit();
+}
+
+double lmc_compileWeight(qint64 bytes, int includes)
+{
+    return double(bytes) / 1024 + kIncludeWeight * includes;
+}
+
+void LmcCompileEstimate::addTimed(double weight, qint64 ms)
+{
+    if (weight <= 0 || ms <= 0)
+        return;
+    m_weight += weight;
+    m_ms += ms;
+}
+
+qint64 LmcCompileEstimate::estimateMs(double weight) const
+{
+    const double rate = m_weight > 0 ? double(m_ms) / m_weight : kDefaultMsPerWeight;
+    return qMax<qint64>(1, qint64(weight * rate));
+}
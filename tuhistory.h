@@ -0,0 +1,33 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QHash>
+#include <QString>
+
+// what earlier compiles of a TU measured, kept per build dir in build/lmc_tu.history.
+// clean() leaves it alone: a clean rebuild is when every TU compiles at once
+struct LmcTuHistory
+{
+    qint64 peakRssKb = 0; // the compiler's peak resident memory, 0: never measured
+    qint64 compileMs = 0; // how long its last good compile took, 0: never timed
+};
+
+// keyed by source path (a unity batch by its batch file), empty when there's no history
+QHash<QString, LmcTuHistory> lmc_readTuHistory(const QString &buildDir);
+bool lmc_writeTuHistory(const QString &buildDir, const QHash<QString, LmcTuHistory> &history);
+
+// relative cost of compiling a TU nobody has timed yet: its size in KB plus a fixed
+// share per direct #include, which is where most of the parsing comes from
+double lmc_compileWeight(qint64 bytes, int includes);
+
+// turns weights into time at the rate the timed TUs of this build dir went at, a plain
+// guess until there are any
+class LmcCompileEstimate
+{
+public:
+    void addTimed(double weight, qint64 ms);
+    qint64 estimateMs(double weight) const;
+
+private:
+    double m_weight = 0;
+    qint64 m_ms = 0;
+};
@@ -0,0 +1,101 @@
+// (c) 2025 Stardust Softworks
+#include "unity.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+// auto batch size aims for batches no bigger than this much source text
+static const qint64 kUnityBatchBytes = 256 * 1024;
+
+static QString lmc_unitySkipPath(const QString &buildDir)
+{
+    return QDir(buildDir).absoluteFilePath("lmc_unity.skip");
+}
+
+QVector<LmcUnityBatch> lmc_planUnity(const QString &buildDir,
+                                     const QStringList &sources,
+                                     int batchSize,
+                                     int jobs,
+                                     QStringList *standalone)
+{
+    const int n = int(sources.size());
+    if (batchSize <= 0) {
+        qint64 total = 0;
+        for (const QString &src : sources)
+            total += QFileInfo(src).size();
+        const int bySize = int((total + kUnityBatchBytes - 1) / kUnityBatchBytes);
+        const int count = qMax(qMax(jobs, 1), bySize);
+        batchSize = (n + count - 1) / count;
+    }
+    batchSize = qMax(batchSize, 1);
+
+    QVector<LmcUnityBatch> batches;
+    for (int i = 0; i < n; i += batchSize) {
+        const QStringList chunk = sources.mid(i, batchSize);
+        if (chunk.size() < 2) {
+            *standalone << chunk;
+            continue;
+        }
+        LmcUnityBatch b;
+        b.file = QDir(buildDir).absoluteFilePath(
+            QString("lmc_unity_%1.cpp").arg(batches.size() + 1));
+        for (const QString &src : chunk)
+            b.sources << QFileInfo(src).absoluteFilePath();
+        batches << b;
+    }
+    return batches;
+}
+
+void lmc_writeUnityBatch(const LmcUnityBatch &batch)
+{
+    QByteArray text = "// generated by LazyMansClang unity build\n";
+    for (const QString &src : batch.sources)
+        text += "#include \"" + src.toUtf8() + "\"\n";
+
+    QFile current(batch.file);
+    if (current.open(QIODevice::ReadOnly) && current.readAll() == text)
+        return;
+    current.close();
+
+    QSaveFile f(batch.file);
+    if (f.open(QIODevice::WriteOnly)) {
+        f.write(text);
+        f.commit();
+    }
+}
+
+QSet<QString> lmc_readUnitySkip(const QString &buildDir)
+{
+    QSet<QString> skip;
+    QFile f(lmc_unitySkipPath(buildDir));
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return skip;
+    for (const QByteArray &line : f.readAll().split('\n'))
+        if (!line.trimmed().isEmpty())
+            skip.insert(QString::fromUtf8(line.trimmed()));
+    return skip;
+}
+
+void lmc_addUnitySkip(const QString &buildDir, const QStringList &sources)
+{
+    QFile f(lmc_unitySkipPath(buildDir));
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        return;
+    for (const QString &src : sources)
+        f.write(src.toUtf8() + "\n");
+}
+
+QStringList lmc_unityCulprits(const LmcUnityBatch &batch, const QString &output)
+{
+    QStringList culprits;
+    for (const QString &line : output.split('\n')) {
+        if (!line.contains(": error:") && !line.contains(": note:"))
+            continue;
+        for (const QString &src : batch.sources) {
+            if (line.startsWith(src + ":") && !culprits.contains(src))
+                culprits << src;
+        }
+    }
+    return culprits;
+}
@@ -0,0 +1,35 @@
+// (c) 2025 Stardust Softworks
+#pragma once
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+// unity (jumbo) build: sources get compiled a few at a time through generated
+// build/lmc_unity_<n>.cpp files that #include them, so the headers they share are
+// parsed once per batch instead of once per source.
+struct LmcUnityBatch
+{
+    QString file;        // build/lmc_unity_<n>.cpp
+    QStringList sources; // absolute, in include order
+};
+
+// groups sources (in list order) into batches of batchSize files. batchSize 0 picks one
+// from the total source size: enough batches to keep `jobs` compilers busy, none much
+// bigger than a few hundred KB. whatever would end up alone goes to *standalone.
+QVector<LmcUnityBatch> lmc_planUnity(const QString &buildDir,
+                                     const QStringList &sources,
+                                     int batchSize,
+                                     int jobs,
+                                     QStringList *standalone);
+
+// rewrites the batch file only when its content changes
+void lmc_writeUnityBatch(const LmcUnityBatch &batch);
+
+// sources that broke a batch but compile on their own (clashing statics and such),
+// build/lmc_unity.skip
+QSet<QString> lmc_readUnitySkip(const QString &buildDir);
+void lmc_addUnitySkip(const QString &buildDir, const QStringList &sources);
+
+// members of a failed batch its compiler output points at (the error and the note
+// naming the other definition), empty when none can be singled out
+QStringList lmc_unityCulprits(const LmcUnityBatch &batch, const QString &output);